@@ -0,0 +1,140 @@
+// Batch solve benchmark: solves the same set of random scrambles with the
+// two-phase solver through SolveBatch, once per thread count, and prints the
+// throughput, the speedup over one thread, per-solve times and how many
+// solutions came out longer than --max-length as JSON. Exits with 1 unless every
+// scramble got a solution of at most --max-length moves in time.
+//
+//   batch_bench [--scrambles N] [--threads 1,2,4] [--max-length N] [--timeout MS] [--json FILE]
+
+#include <CubeState.h>
+#include <JobSystem.h>
+#include <SolveBatch.h>
+#include <Statistics.h>
+#include <TwoPhaseSolver.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    int scrambles = 2000;
+    std::vector<int> threadCounts;
+    int maxLength = 20;
+    double timeoutMs = 1000.0;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--scrambles") == 0 && i + 1 < argc)
+            scrambles = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            std::istringstream list(argv[++i]);
+            std::string count;
+            while (std::getline(list, count, ','))
+                threadCounts.push_back(std::max(1, std::atoi(count.c_str())));
+        }
+        else if (std::strcmp(argv[i], "--max-length") == 0 && i + 1 < argc)
+            maxLength = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+            timeoutMs = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    // Powers of two up to the core count, and the core count itself
+    const int cores = JobSystem::GetDefaultThreadCount();
+    if (threadCounts.empty())
+    {
+        for (int count = 1; count < cores; count *= 2)
+            threadCounts.push_back(count);
+        threadCounts.push_back(cores);
+    }
+
+    std::mt19937 random(1234);
+    std::vector<CubeState> states(scrambles);
+    for (CubeState& state : states)
+    {
+        for (int move = 0; move < 30; move++)
+            state.ApplyMove((int)(random() % CubeState::MOVE_COUNT));
+    }
+
+    const TwoPhaseSolver solver;
+    const SolveFunction solve = [&](const CubeState& state, std::vector<int>& moves)
+    {
+        return solver.Solve(state, moves, maxLength, timeoutMs);
+    };
+
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"benchmark\": \"batch_solve\",\n"
+        << "  \"scrambles\": " << scrambles << ",\n"
+        << "  \"cores\": " << cores << ",\n"
+        << "  \"max_length\": " << maxLength << ",\n"
+        << "  \"runs\": [\n";
+
+    bool valid = true;
+    double baseline = 0.0;
+    for (size_t run = 0; run < threadCounts.size(); run++)
+    {
+        JobSystem jobs(threadCounts[run]);
+        std::vector<double> solveTimes;
+        size_t solved = 0, tooLong = 0, nextIndex = 0;
+        const auto start = std::chrono::steady_clock::now();
+        SolveBatch(jobs, states, solve, [&](const SolveResult& result)
+        {
+            // Results have to come back in order, and every solution has to solve its cube
+            CubeState check = states[result.index];
+            check.ApplyMoves(result.moves);
+            valid = valid && result.index == nextIndex++ && (!result.solved || check.IsSolved());
+            solved += result.solved;
+            // The solver gives up rather than hand back a longer one, so this should stay 0
+            tooLong += result.solved && (int)result.moves.size() > maxLength;
+            solveTimes.push_back(result.solveMs);
+            return true;
+        });
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        valid = valid && nextIndex == states.size() && solved == states.size() && tooLong == 0;
+
+        const double rate = scrambles / seconds;
+        if (run == 0)
+            baseline = rate / threadCounts[0];
+        std::sort(solveTimes.begin(), solveTimes.end());
+        json << (run == 0 ? "" : ",\n")
+            << "    { \"threads\": " << threadCounts[run]
+            << ", \"solves_per_sec\": " << rate
+            << ", \"speedup\": " << rate / baseline
+            << ", \"efficiency\": " << rate / baseline / threadCounts[run]
+            << ", \"solved\": " << solved
+            << ", \"over_max_length\": " << tooLong
+            << ", \"solve_ms\": { \"p50\": " << Percentile(solveTimes, 50) << ", \"p95\": " << Percentile(solveTimes, 95)
+            << ", \"p99\": " << Percentile(solveTimes, 99) << ", \"max\": " << solveTimes.back() << " } }";
+    }
+    json << "\n  ],\n"
+        << "  \"valid\": " << (valid ? "true" : "false") << "\n"
+        << "}\n";
+
+    std::cout << json.str();
+    if (!jsonPath.empty())
+    {
+        std::ofstream stream(jsonPath);
+        stream << json.str();
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return valid ? 0 : 1;
+}
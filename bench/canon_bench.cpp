@@ -0,0 +1,181 @@
+// Move canonicalization benchmark: runs MoveSequence over long random move
+// sequences, checks that the canonical sequences leave the cube exactly as the
+// originals do, and prints moves per second and how much shorter the
+// sequences got as JSON.
+//
+//   canon_bench [--length N] [--size N] [--rounds N] [--json FILE]
+
+#include <CubeGrid.h>
+#include <CubeState.h>
+#include <MoveSequence.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Best of rounds runs of work, in seconds
+static double Time(int rounds, const std::function<void()>& work)
+{
+    double best = 1e30;
+    for (int round = 0; round < rounds; round++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        work();
+        best = std::min(best, SecondsSince(start));
+    }
+    return best;
+}
+
+static bool SameFaceMoveResult(const std::vector<int>& original, const std::vector<int>& canonical)
+{
+    CubeState first, second;
+    first.ApplyMoves(original);
+    second.ApplyMoves(canonical);
+    return std::memcmp(&first, &second, sizeof(first)) == 0;
+}
+
+static bool SameLayerTurnResult(int size, const std::vector<LayerTurn>& original, const std::vector<LayerTurn>& canonical)
+{
+    CubeGrid first(size), second(size);
+    for (const LayerTurn& turn : original)
+        first.ApplyTurn(turn);
+    for (const LayerTurn& turn : canonical)
+        second.ApplyTurn(turn);
+    std::string firstFacelets, secondFacelets;
+    return first.GetFacelets(firstFacelets) && second.GetFacelets(secondFacelets) && firstFacelets == secondFacelets;
+}
+
+static bool IsCanonical(const std::vector<LayerTurn>& turns)
+{
+    for (size_t i = 1; i < turns.size(); i++)
+    {
+        if (!MoveSequence::CanFollow(turns[i - 1], turns[i]))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t length = 10000000;
+    int size = 5;
+    int rounds = 3;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--length") == 0 && i + 1 < argc)
+            length = (size_t)std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            size = std::max(2, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    std::mt19937 random(1234);
+
+    // Uniformly random face moves, and face moves the way they get typed: the same key
+    // pressed a few times in a row, now and then undone
+    std::vector<int> randomMoves(length), typedMoves;
+    for (int& move : randomMoves)
+        move = (int)(random() % CubeState::MOVE_COUNT);
+    typedMoves.reserve(length);
+    while (typedMoves.size() < length)
+    {
+        const int move = (int)(random() % CubeState::MOVE_COUNT);
+        for (int repeat = 1 + (int)(random() % 3); repeat > 0 && typedMoves.size() < length; repeat--)
+            typedMoves.push_back(move);
+        if (random() % 4 == 0 && typedMoves.size() < length)
+            typedMoves.push_back(move / 3 * 3 + 2 - move % 3);
+    }
+    // Quarter and half turns of any layer of a size x size x size cube
+    std::vector<LayerTurn> layerTurns(length);
+    for (LayerTurn& turn : layerTurns)
+    {
+        static const int s_EighthTurns[] = { 2, -2, 4, -4 };
+        turn.axisIndex = (int)(random() % 3);
+        turn.layer = (int)(random() % size);
+        turn.eighthTurns = s_EighthTurns[random() % 4];
+    }
+
+    std::vector<int> canonicalRandom, canonicalTyped;
+    std::vector<LayerTurn> canonicalLayers;
+    const double randomSeconds = Time(rounds, [&]() { canonicalRandom = randomMoves; MoveSequence::Canonicalize(canonicalRandom); });
+    const double typedSeconds = Time(rounds, [&]() { canonicalTyped = typedMoves; MoveSequence::Canonicalize(canonicalTyped); });
+    const double layerSeconds = Time(rounds, [&]() { canonicalLayers = layerTurns; MoveSequence::Canonicalize(canonicalLayers); });
+    // The live stage: every turn pushed as it arrives and popped as the animation takes it
+    size_t streamed = 0;
+    const double streamSeconds = Time(rounds, [&]()
+    {
+        MoveSequence pending;
+        streamed = 0;
+        for (size_t i = 0; i < layerTurns.size(); i++)
+        {
+            pending.Push(layerTurns[i]);
+            if (i % 4 == 3)
+            {
+                while (!pending.IsEmpty())
+                {
+                    pending.PopFront();
+                    streamed++;
+                }
+            }
+        }
+        streamed += pending.GetSize();
+    });
+
+    // The cube grid is slow for big cubes, so the layer turns are checked on a prefix
+    const size_t checkedLength = std::min<size_t>(length, 200000);
+    std::vector<LayerTurn> checkedTurns(layerTurns.begin(), layerTurns.begin() + checkedLength);
+    std::vector<LayerTurn> checkedCanonical = checkedTurns;
+    MoveSequence::Canonicalize(checkedCanonical);
+    const bool matches = SameFaceMoveResult(randomMoves, canonicalRandom) && SameFaceMoveResult(typedMoves, canonicalTyped) &&
+                         SameLayerTurnResult(size, checkedTurns, checkedCanonical) && IsCanonical(canonicalLayers);
+
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"benchmark\": \"canonicalize\",\n"
+        << "  \"length\": " << length << ",\n"
+        << "  \"size\": " << size << ",\n"
+        << "  \"random_face_moves\": { \"moves_per_sec\": " << length / randomSeconds
+        << ", \"kept\": " << (double)canonicalRandom.size() / length << " },\n"
+        << "  \"typed_face_moves\": { \"moves_per_sec\": " << length / typedSeconds
+        << ", \"kept\": " << (double)canonicalTyped.size() / length << " },\n"
+        << "  \"layer_turns\": { \"moves_per_sec\": " << length / layerSeconds
+        << ", \"kept\": " << (double)canonicalLayers.size() / length << " },\n"
+        << "  \"streamed_layer_turns\": { \"moves_per_sec\": " << length / streamSeconds
+        << ", \"kept\": " << (double)streamed / length << " },\n"
+        << "  \"matches_original\": " << (matches ? "true" : "false") << "\n"
+        << "}\n";
+
+    std::cout << json.str();
+    if (!jsonPath.empty())
+    {
+        std::ofstream stream(jsonPath);
+        stream << json.str();
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+// Headless rendering benchmark: drives the regular Shader/Texture/VertexArray
+// stack (through CubeRenderer) along a scripted camera path while replaying a
+// move sequence, and prints frame time percentiles, draw calls and upload
+// volume as JSON.
+//
+//   render_bench [--frames N] [--warmup N] [--size N] [--cubes N]
+//                [--path static|orbit|zoom] [--moves "R U R' U'"]
+//                [--buffer-mode static|dynamic|stream|persistent]
+//                [--no-instancing] [--json FILE]
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <Debugger.h>
+#include <UniformBuffer.h>
+#include <GLState.h>
+#include <GLExtensions.h>
+#include <Camera.h>
+#include <CubeRenderer.h>
+#include <CubeFaceRotations.h>
+#include <FrameBuffer.h>
+#include <HeadlessContext.h>
+#include <Simulation.h>
+#include <Statistics.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const int width = 800;
+const int height = 800;
+
+int main(int argc, char* argv[])
+{
+    int frames = 300;
+    int warmup = 30;
+    int size = 3;
+    int cubes = 1;
+    std::string path = "orbit";
+    std::string moveText = "R U R' U' F2 L' D B2";
+    bool instanced = true;
+    std::string bufferMode = "persistent";
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            warmup = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            size = std::max(2, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--cubes") == 0 && i + 1 < argc)
+            cubes = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--path") == 0 && i + 1 < argc)
+            path = argv[++i];
+        else if (std::strcmp(argv[i], "--moves") == 0 && i + 1 < argc)
+            moveText = argv[++i];
+        else if (std::strcmp(argv[i], "--buffer-mode") == 0 && i + 1 < argc)
+            bufferMode = argv[++i];
+        else if (std::strcmp(argv[i], "--no-instancing") == 0)
+            instanced = false;
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (path != "static" && path != "orbit" && path != "zoom")
+    {
+        std::cerr << "Unknown camera path " << path << std::endl;
+        return 1;
+    }
+    BufferUsage instanceUsage;
+    if (bufferMode == "static")
+        instanceUsage = BufferUsage::Static;
+    else if (bufferMode == "dynamic")
+        instanceUsage = BufferUsage::Dynamic;
+    else if (bufferMode == "stream")
+        instanceUsage = BufferUsage::Stream;
+    else if (bufferMode == "persistent")
+        instanceUsage = BufferUsage::Persistent;
+    else
+    {
+        std::cerr << "Unknown buffer mode " << bufferMode << std::endl;
+        return 1;
+    }
+
+    std::vector<LayerTurn> moves;
+    if (!CubeGrid::ParseMoves(moveText, size, moves))
+    {
+        std::cerr << "Can't parse moves \"" << moveText << "\" for a " << size << "x" << size << "x" << size << " cube" << std::endl;
+        return 1;
+    }
+
+    HeadlessContext context;
+    if (!context.IsValid())
+        return 1;
+    gladLoadGLLoader((GLADloadproc)HeadlessContext::GetProcAddress);
+    GLDebugInit((GLADloadproc)HeadlessContext::GetProcAddress);
+
+    std::vector<double> frameTimes;
+    unsigned long long drawCalls = 0, bytesUploaded = 0, bindsIssued = 0;
+    std::string renderer = (const char*)glGetString(GL_RENDERER);
+
+    {
+        // Lay the cubes out on a square grid, one cube width apart
+        const int columns = (int)std::ceil(std::sqrt((double)cubes));
+        const float spacing = size + 1.0f;
+        std::vector<glm::mat4> placements;
+        for (int i = 0; i < cubes; i++)
+        {
+            glm::vec3 offset((i % columns - (columns - 1) * 0.5f) * spacing, 0.0f, (i / columns - (columns - 1) * 0.5f) * spacing);
+            placements.push_back(glm::translate(glm::mat4(1.0f), offset));
+        }
+
+        // Only the surface cubies are stored and drawn
+        InitCubies(size);
+        CubeRenderer cubeRenderer(g_cubieMatrices.size(), instanced, instanceUsage);
+        if (instanceUsage == BufferUsage::Persistent && !GLExtensions::BufferStorage)
+            bufferMode = "stream";
+
+        // Keep the whole scene in view
+        const float extent = columns * spacing;
+        const float distance = 3.5f * extent;
+        Camera camera(width, height);
+        camera.SetPerspective(45.0f, 0.1f, std::max(100.0f, 4.0f * distance));
+        camera.SetPosition(glm::vec3(0.0f, 0.0f, distance));
+
+        FrameBuffer offscreen(width, height);
+        offscreen.Bind();
+        UniformBuffer frameConstants(FRAME_CONSTANTS_BINDING, sizeof(FrameConstants));
+
+        // The simulation steps on this thread, so the scripted moves start on the frame they are queued
+        const float deltaTime = 1.0f / 60.0f;
+        Simulation simulation(deltaTime);
+        size_t nextMove = 0;
+        frameTimes.reserve(frames);
+
+        for (int frame = 0; frame < warmup + frames; frame++)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            if (path == "orbit")
+                camera.SetRotation(30.0f, 45.0f + frame * 1.5f);
+            else if (path == "zoom")
+                camera.SetPosition(glm::vec3(0.0f, 0.0f, distance * (0.6f + 0.4f * std::sin(frame * 0.05f))));
+
+            // Start the next scripted move as soon as the previous one has landed
+            if (!g_rotationAnimation.active && g_moveQueue.IsEmpty() && g_pendingTurns.IsEmpty() && !moves.empty())
+            {
+                QueueFaceRotation(moves[nextMove]);
+                nextMove = (nextMove + 1) % moves.size();
+            }
+            simulation.AdvanceTo((frame + 1) * deltaTime);
+            const CubeSnapshot& snapshot = simulation.Acquire();
+
+            GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+            GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+            camera.UpdateFrameConstants(frameConstants, frame * deltaTime);
+            cubeRenderer.Draw(snapshot, simulation.GetAlpha(snapshot, (frame + 1) * deltaTime), placements);
+            frameConstants.EndFrame();
+
+            // There is no swap to pace against, so wait for the GPU to count its share of the frame
+            GLCall(glFinish());
+            auto end = std::chrono::steady_clock::now();
+
+            GLState::EndFrame();
+            if (frame < warmup)
+                continue;
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            drawCalls += GLState::GetFrameCounters().drawCalls;
+            bytesUploaded += GLState::GetFrameCounters().bytesUploaded;
+            bindsIssued += GLState::GetFrameCounters().issued;
+        }
+    }
+
+    double total = 0.0;
+    for (double time : frameTimes)
+        total += time;
+    std::vector<double> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"benchmark\": \"render\",\n"
+        << "  \"renderer\": \"" << renderer << "\",\n"
+        << "  \"frames\": " << frames << ",\n"
+        << "  \"size\": " << size << ",\n"
+        << "  \"cubes\": " << cubes << ",\n"
+        << "  \"cubies_drawn\": " << (unsigned long long)g_cubieMatrices.size() * cubes << ",\n"
+        << "  \"path\": \"" << path << "\",\n"
+        << "  \"instanced\": " << (instanced ? "true" : "false") << ",\n"
+        << "  \"buffer_mode\": \"" << bufferMode << "\",\n"
+        << "  \"frame_ms\": { \"mean\": " << total / sorted.size()
+        << ", \"p50\": " << Percentile(sorted, 50) << ", \"p95\": " << Percentile(sorted, 95)
+        << ", \"p99\": " << Percentile(sorted, 99) << ", \"max\": " << sorted.back() << " },\n"
+        << "  \"draw_calls_per_frame\": " << (double)drawCalls / frames << ",\n"
+        << "  \"bytes_uploaded_per_frame\": " << (double)bytesUploaded / frames << ",\n"
+        << "  \"binds_issued_per_frame\": " << (double)bindsIssued / frames << "\n"
+        << "}\n";
+
+    std::cout << json.str();
+    if (!jsonPath.empty())
+    {
+        std::ofstream stream(jsonPath);
+        stream << json.str();
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
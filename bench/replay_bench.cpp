@@ -0,0 +1,166 @@
+// Move log benchmark: records a long session of random turns with MoveLogWriter,
+// reads it back with MoveLogReader, checks every turn and the final cube match,
+// and prints the append cost, bytes per turn and replay rates (decoding alone,
+// and decoding straight onto the cube state) as JSON.
+//
+//   replay_bench [--turns N] [--size N] [--rounds N] [--log FILE] [--json FILE]
+
+#include <CubeGrid.h>
+#include <MoveLog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Best of rounds runs of work, in seconds
+static double Time(int rounds, const std::function<void()>& work)
+{
+    double best = 1e30;
+    for (int round = 0; round < rounds; round++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        work();
+        best = std::min(best, SecondsSince(start));
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t turnCount = 5000000;
+    int size = 3;
+    int rounds = 3;
+    std::string logPath;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--turns") == 0 && i + 1 < argc)
+            turnCount = (size_t)std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            size = std::max(2, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+            logPath = argv[++i];
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    // Without --log the log is only kept for the run
+    const bool keepLog = !logPath.empty();
+    if (!keepLog)
+        logPath = "replay_bench.mlog";
+
+    // Quarter and half turns of any layer, a few per second like a fast solver at the keys
+    static const int s_Angles[4] = { 2, -2, 4, -4 };
+    std::mt19937 random(1234);
+    std::vector<LoggedTurn> session(turnCount);
+    double time = 0.0;
+    for (LoggedTurn& logged : session)
+    {
+        logged.turn = { (int)(random() % 3), (int)(random() % size), s_Angles[random() % 4] };
+        time += (random() % 400) / 1000.0;
+        logged.time = time;
+    }
+
+    double appendNs = 0.0, closeMs = 0.0;
+    {
+        MoveLogWriter writer(logPath, size);
+        if (!writer.IsValid())
+            return 1;
+        auto start = std::chrono::steady_clock::now();
+        for (const LoggedTurn& logged : session)
+            writer.Append(logged.turn, logged.time);
+        appendNs = SecondsSince(start) * 1e9 / turnCount;
+        start = std::chrono::steady_clock::now();
+        writer.Flush();
+        closeMs = SecondsSince(start) * 1000.0;
+    }
+
+    MoveLogReader reader(logPath);
+    if (!reader.IsValid())
+    {
+        std::cerr << "Could not read back " << logPath << std::endl;
+        return 1;
+    }
+
+    // Every turn and time has to come back as recorded (to the millisecond, and half turns either way)
+    bool valid = true;
+    LoggedTurn logged;
+    for (const LoggedTurn& recorded : session)
+    {
+        valid = valid && reader.Next(logged) && logged.turn.axisIndex == recorded.turn.axisIndex && logged.turn.layer == recorded.turn.layer
+            && ((logged.turn.eighthTurns - recorded.turn.eighthTurns) & 7) == 0 && std::abs(logged.time - recorded.time) < 0.0005;
+    }
+    valid = valid && !reader.Next(logged) && reader.IsAtEnd();
+
+    size_t decoded = 0;
+    const double decodeSeconds = Time(rounds, [&]()
+    {
+        reader.Rewind();
+        decoded = 0;
+        while (reader.Next(logged))
+            decoded += logged.turn.layer + 1;
+    });
+    CubeGrid replayed(size);
+    const double replaySeconds = Time(rounds, [&]()
+    {
+        reader.Rewind();
+        replayed = CubeGrid(size);
+        while (reader.Next(logged))
+            replayed.ApplyTurn(logged.turn);
+    });
+
+    CubeGrid expected(size);
+    for (const LoggedTurn& recorded : session)
+        expected.ApplyTurn(recorded.turn);
+    std::string expectedFacelets, replayedFacelets;
+    valid = valid && expected.GetFacelets(expectedFacelets) && replayed.GetFacelets(replayedFacelets) && expectedFacelets == replayedFacelets;
+
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"benchmark\": \"move_log\",\n"
+        << "  \"turns\": " << turnCount << ",\n"
+        << "  \"size\": " << size << ",\n"
+        << "  \"bytes\": " << reader.GetByteSize() << ",\n"
+        << "  \"bytes_per_turn\": " << (double)reader.GetByteSize() / turnCount << ",\n"
+        << "  \"append_ns\": " << appendNs << ",\n"
+        << "  \"flush_ms\": " << closeMs << ",\n"
+        << "  \"decode_turns_per_sec\": " << turnCount / decodeSeconds << ",\n"
+        << "  \"replay_turns_per_sec\": " << turnCount / replaySeconds << ",\n"
+        << "  \"valid\": " << (valid && decoded > 0 ? "true" : "false") << "\n"
+        << "}\n";
+
+    if (!keepLog)
+        std::remove(logPath.c_str());
+    std::cout << json.str();
+    if (!jsonPath.empty())
+    {
+        std::ofstream stream(jsonPath);
+        stream << json.str();
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return valid ? 0 : 1;
+}
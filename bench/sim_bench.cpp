@@ -0,0 +1,129 @@
+// Bulk move simulation benchmark: applies move sequences to a batch of cubes
+// with every CubeBatch backend the CPU supports and with CubeState one cube at
+// a time, checks that they all end in the same states, and prints moves per
+// second on one core as JSON.
+//
+//   sim_bench [--cubes N] [--length N] [--rounds N] [--json FILE]
+
+#include <CubeBatch.h>
+#include <CubeState.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t cubes = 1 << 16;
+    size_t length = 100;
+    int rounds = 5;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--cubes") == 0 && i + 1 < argc)
+            cubes = (size_t)std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--length") == 0 && i + 1 < argc)
+            length = (size_t)std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // A random sequence of its own for every cube, and one shared sequence
+    std::mt19937 random(1234);
+    std::vector<unsigned char> sequences(cubes * length);
+    for (unsigned char& move : sequences)
+        move = (unsigned char)(random() % CubeState::MOVE_COUNT);
+    std::vector<int> shared(length);
+    for (int& move : shared)
+        move = (int)(random() % CubeState::MOVE_COUNT);
+
+    // The reference: CubeState, one cube at a time
+    std::vector<CubeState> reference(cubes);
+    const auto referenceStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < cubes; i++)
+    {
+        for (size_t k = 0; k < length; k++)
+            reference[i].ApplyMove(sequences[i * length + k]);
+    }
+    const double referenceRate = cubes * length / SecondsSince(referenceStart);
+
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"benchmark\": \"simulation\",\n"
+        << "  \"cubes\": " << cubes << ",\n"
+        << "  \"length\": " << length << ",\n"
+        << "  \"rounds\": " << rounds << ",\n"
+        << "  \"cubestate_moves_per_sec\": " << referenceRate << ",\n"
+        << "  \"backends\": [\n";
+
+    bool first = true, matches = true;
+    for (CubeBatch::Backend backend : { CubeBatch::Backend::Scalar, CubeBatch::Backend::SSSE3, CubeBatch::Backend::AVX2 })
+    {
+        if (CubeBatch::GetSupportedBackend(backend) != backend)
+            continue;
+        CubeBatch batch(cubes, backend);
+
+        // Best of a few rounds, each from solved cubes
+        double sequencesSeconds = 1e30, sharedSeconds = 1e30;
+        for (int round = 0; round < rounds; round++)
+        {
+            batch.Reset();
+            auto start = std::chrono::steady_clock::now();
+            batch.ApplySequences(sequences.data(), length);
+            sequencesSeconds = std::min(sequencesSeconds, SecondsSince(start));
+
+            for (size_t i = 0; i < cubes; i++)
+            {
+                const CubeState state = batch[i].ToState();
+                if (std::memcmp(&state, &reference[i], sizeof(state)) != 0)
+                    matches = false;
+            }
+
+            batch.Reset();
+            start = std::chrono::steady_clock::now();
+            batch.ApplyMoves(shared);
+            sharedSeconds = std::min(sharedSeconds, SecondsSince(start));
+        }
+
+        json << (first ? "" : ",\n")
+            << "    { \"backend\": \"" << CubeBatch::GetBackendName(backend) << "\""
+            << ", \"sequences_moves_per_sec\": " << cubes * length / sequencesSeconds
+            << ", \"shared_moves_per_sec\": " << cubes * length / sharedSeconds << " }";
+        first = false;
+    }
+    json << "\n  ],\n"
+        << "  \"matches_cubestate\": " << (matches ? "true" : "false") << "\n"
+        << "}\n";
+
+    std::cout << json.str();
+    if (!jsonPath.empty())
+    {
+        std::ofstream stream(jsonPath);
+        stream << json.str();
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// Symmetry reduction benchmark: builds the optimal solver's corner database both
+// over all 88 million corner states and over the classes the 16 U-D symmetries
+// leave, checks the two agree on random cubes, and prints their memory and the
+// cost of a lookup (state to entry to distance) as JSON. The edge database is
+// too large to build without reduction (5.1 billion entries), so for it and for
+// the solver as a whole only the memory is compared, and the edge entries of
+// symmetric cubes are checked to be entries of the same class.
+//
+//   sym_bench [--states N] [--passes N] [--threads N] [--json FILE]
+
+#include <CubeState.h>
+#include <CubeSymmetry.h>
+#include <OptimalSolver.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct LookupResult
+{
+    double entryNs;       // State to entry
+    double lookupNs;      // State to entry to distance
+    uint64_t entrySum;    // Keep the loops from being optimized away
+    uint64_t distanceSum;
+};
+
+// Every state looked up passes times, first only to its entry, then through to the distance
+static LookupResult MeasureLookups(const std::vector<CubeState>& states, int passes, const unsigned char* table, bool symmetryReduced)
+{
+    LookupResult result;
+    result.entrySum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (const CubeState& state : states)
+            result.entrySum += OptimalSolver::GetCornerEntry(state, symmetryReduced);
+    }
+    result.entryNs = SecondsSince(start) * 1e9 / ((double)states.size() * passes);
+
+    result.distanceSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (const CubeState& state : states)
+            result.distanceSum += OptimalSolver::GetDistance(table, OptimalSolver::GetCornerEntry(state, symmetryReduced));
+    }
+    result.lookupNs = SecondsSince(start) * 1e9 / ((double)states.size() * passes);
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    int stateCount = 1 << 20;
+    int passes = 4;
+    int threads = 0;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--states") == 0 && i + 1 < argc)
+            stateCount = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--passes") == 0 && i + 1 < argc)
+            passes = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    CornerSymmetry::Get();
+    const double conversionMs = SecondsSince(start) * 1000.0;
+
+    // The breadth-first searches report their progress on stdout, which is the JSON's
+    std::streambuf* output = std::cout.rdbuf(std::cerr.rdbuf());
+    start = std::chrono::steady_clock::now();
+    const std::vector<unsigned char> reduced = OptimalSolver::BuildCornerTable(true, threads);
+    const double reducedSeconds = SecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    const std::vector<unsigned char> full = OptimalSolver::BuildCornerTable(false, threads);
+    const double fullSeconds = SecondsSince(start);
+    std::cout.rdbuf(output);
+
+    std::mt19937 random(1234);
+    std::vector<CubeState> states(stateCount);
+    for (CubeState& state : states)
+    {
+        for (int move = 0; move < 25; move++)
+            state.ApplyMove((int)(random() % CubeState::MOVE_COUNT));
+    }
+
+    // Both have to give every state the same distance, and so must everything symmetric to it
+    size_t mismatches = 0;
+    const EdgeSymmetry& edgeSymmetry = EdgeSymmetry::Get();
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        // A symmetric cube's edges land on one of the entries standing for the cube's own
+        unsigned char slots[CubeState::EDGE_COUNT], flips[CubeState::EDGE_COUNT];
+        unsigned char symmetricSlots[CubeState::EDGE_COUNT], symmetricFlips[CubeState::EDGE_COUNT];
+        const CubeState edgeSymmetric = CubeSymmetry::Conjugate(states[i], (int)(i % CubeSymmetry::UD_COUNT));
+        for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+        {
+            slots[states[i].ep[slot]] = (unsigned char)slot;
+            flips[states[i].ep[slot]] = states[i].eo[slot];
+            symmetricSlots[edgeSymmetric.ep[slot]] = (unsigned char)slot;
+            symmetricFlips[edgeSymmetric.ep[slot]] = edgeSymmetric.eo[slot];
+        }
+        int entries[CubeSymmetry::UD_COUNT];
+        const int entryCount = edgeSymmetry.GetSymmetricEntries(edgeSymmetry.GetEntry(slots, flips), entries);
+        mismatches += std::find(entries, entries + entryCount, edgeSymmetry.GetEntry(symmetricSlots, symmetricFlips)) == entries + entryCount;
+
+        const int distance = OptimalSolver::GetDistance(full.data(), OptimalSolver::GetCornerEntry(states[i], false));
+        const CubeState symmetric = CubeSymmetry::Conjugate(states[i], (int)(i % CubeSymmetry::COUNT));
+        mismatches += OptimalSolver::GetDistance(reduced.data(), OptimalSolver::GetCornerEntry(states[i], true)) != distance;
+        mismatches += OptimalSolver::GetDistance(reduced.data(), OptimalSolver::GetCornerEntry(symmetric, true)) != distance;
+    }
+
+    const LookupResult fullLookups = MeasureLookups(states, passes, full.data(), false);
+    const LookupResult reducedLookups = MeasureLookups(states, passes, reduced.data(), true);
+    const size_t reducedBytes = reduced.size() + CornerSymmetry::GetTableSize();
+
+    // The whole solver: both databases at 4 bits an entry, and with reduction the conversion tables
+    uint64_t solverFullBytes = 0, solverReducedBytes = CornerSymmetry::GetTableSize() + EdgeSymmetry::GetTableSize();
+    for (OptimalSolver::Table table : { OptimalSolver::CORNERS, OptimalSolver::EDGES })
+    {
+        solverFullBytes += (OptimalSolver::GetEntryCount(table, false) + 1) / 2;
+        solverReducedBytes += (OptimalSolver::GetEntryCount(table, true) + 1) / 2;
+    }
+
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"benchmark\": \"symmetry_reduction\",\n"
+        << "  \"table\": \"corners\",\n"
+        << "  \"symmetries\": " << CubeSymmetry::UD_COUNT << ",\n"
+        << "  \"states\": " << stateCount << ",\n"
+        << "  \"passes\": " << passes << ",\n"
+        << "  \"full\": { \"entries\": " << full.size() * 2
+        << ", \"bytes\": " << full.size()
+        << ", \"build_s\": " << fullSeconds
+        << ", \"entry_ns\": " << fullLookups.entryNs
+        << ", \"lookup_ns\": " << fullLookups.lookupNs << " },\n"
+        << "  \"reduced\": { \"entries\": " << CornerSymmetry::ENTRY_COUNT
+        << ", \"classes\": " << CornerSymmetry::CLASS_COUNT
+        << ", \"bytes\": " << reducedBytes
+        << ", \"conversion_bytes\": " << CornerSymmetry::GetTableSize()
+        << ", \"conversion_ms\": " << conversionMs
+        << ", \"build_s\": " << reducedSeconds
+        << ", \"entry_ns\": " << reducedLookups.entryNs
+        << ", \"lookup_ns\": " << reducedLookups.lookupNs << " },\n"
+        << "  \"memory_ratio\": " << (double)full.size() / reducedBytes << ",\n"
+        << "  \"solver\": { \"edge_entries\": " << OptimalSolver::GetEntryCount(OptimalSolver::EDGES, true)
+        << ", \"edge_entries_full\": " << OptimalSolver::GetEntryCount(OptimalSolver::EDGES, false)
+        << ", \"full_bytes\": " << solverFullBytes
+        << ", \"reduced_bytes\": " << solverReducedBytes
+        << ", \"memory_ratio\": " << (double)solverFullBytes / solverReducedBytes << " },\n"
+        << "  \"lookup_speedup\": " << fullLookups.lookupNs / reducedLookups.lookupNs << ",\n"
+        << "  \"mismatches\": " << mismatches << ",\n"
+        << "  \"valid\": " << (mismatches == 0 && fullLookups.distanceSum == reducedLookups.distanceSum ? "true" : "false") << "\n"
+        << "}\n";
+
+    std::cout << json.str();
+    if (!jsonPath.empty())
+    {
+        std::ofstream stream(jsonPath);
+        stream << json.str();
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -1,10 +1,10 @@
 #include <Camera.h>
+#include <InputLatency.h>
+#include <Profiler.h>
 #include <string>
 #include <vector>
 #include <iostream>
 
-extern std::vector<glm::mat4> g_cubieMatrices;
-
 void PrintCameraMapping(Camera* camera) {
     auto getMapping = [&](glm::vec3 worldDir) {
         Camera::AxisMapping mapping = camera->GetWorldToLocalMapping(worldDir);
@@ -66,11 +66,12 @@ void Camera::HandleMouseMovement(double xpos, double ypos, bool leftButtonPresse
 void Camera::HandleScroll(double yoffset)
 {
     // Adjust the Z position. Scrolling up (positive yoffset) moves the camera closer.
-    m_Position.z -= (float)yoffset * 0.5f;
+    // The step scales with the zoom range, 0.5 per notch for the default one.
+    m_Position.z -= (float)yoffset * (m_MaxZoom - m_MinZoom) / 96.0f;
 
     // Clamp the zoom distance to keep the cube visible and prevent flipping the view
-    if (m_Position.z < 2.0f) m_Position.z = 2.0f;
-    if (m_Position.z > 50.0f) m_Position.z = 50.0f;
+    if (m_Position.z < m_MinZoom) m_Position.z = m_MinZoom;
+    if (m_Position.z > m_MaxZoom) m_Position.z = m_MaxZoom;
 
     UpdateViewMatrix();
 }
@@ -98,45 +99,62 @@ void Camera::SetPerspective(float fovDegree, float near, float far)
     UpdateViewMatrix();
 }
 
+FrameConstants Camera::GetFrameConstants(float time) const
+{
+    FrameConstants constants;
+    constants.View = m_View;
+    constants.Projection = m_Projection;
+    constants.ViewProj = m_Projection * m_View;
+    constants.Time = time;
+    return constants;
+}
+
+void Camera::UpdateFrameConstants(UniformBuffer& frameConstants, float time) const
+{
+    const FrameConstants constants = GetFrameConstants(time);
+    frameConstants.SetData(&constants);
+}
+
 /////////////////////
 // Input Callbacks //
 /////////////////////
 
-void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+// Act on a key, true when it queued a turn
+static bool HandleKey(GLFWwindow* window, Camera* camera, int key, int action, int mods)
 {
-    Camera* camera = (Camera*) glfwGetWindowUserPointer(window);
-    if (!camera) {
-        std::cout << "Warning: Camera wasn't set as the Window User Pointer! KeyCallback is skipped" << std::endl;
-        return;
-    }
-
     // Persistent turn angle state
     static float s_TurnAngle = 90.0f;
-    static bool axisLocked[3][2];// {{X, -X}, Y, -Y, Z, -Z
+    static int s_LayerDepth = 1;
     if (action == GLFW_PRESS)
     {
         if (key == GLFW_KEY_Z && s_TurnAngle < 180.0f) {
             s_TurnAngle *= 2.0f;
             std::cout << "Current Turn Angle: " << s_TurnAngle << " degrees" << std::endl;
-            return;
+            return false;
         }
         if (key == GLFW_KEY_A && s_TurnAngle  > 45.0f ) {
             s_TurnAngle /= 2.0f;
             std::cout << "Current Turn Angle: " << s_TurnAngle << " degrees" << std::endl;
-            return;
+            return false;
+        }
+        // Enter solves the cube and plays the solution, Shift + Enter in the fewest moves possible
+        if (key == GLFW_KEY_ENTER) {
+            QueueSolution((mods & GLFW_MOD_SHIFT) != 0);
+            return false;
+        }
+        // Digits pick which layer the face keys turn, counted from the face (1 = the face itself)
+        if (key >= GLFW_KEY_1 && key <= GLFW_KEY_9 && key - GLFW_KEY_0 <= g_cube.GetSize()) {
+            s_LayerDepth = key - GLFW_KEY_0;
+            std::cout << "Current Layer: " << s_LayerDepth << std::endl;
+            return false;
         }
     }
 
-    // Prevent overlapping animations
-    extern RotationAnimation g_rotationAnimation;
-    if (g_rotationAnimation.active) return;
-    
-    
     if (action == GLFW_PRESS || action == GLFW_REPEAT)
     {
         // Use Space key state for reverse rotation
         bool reverse = (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS);
-        float baseAngle = reverse ? glm::radians(-s_TurnAngle) : glm::radians(s_TurnAngle);
+        int baseEighths = (int)(s_TurnAngle / 45.0f) * (reverse ? -1 : 1);
         
         
         // 2. Define the world-space direction associated with the key
@@ -150,7 +168,7 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
             case GLFW_KEY_U: worldDir = glm::vec3(0, 1, 0);  break; // Up
             case GLFW_KEY_D: worldDir = glm::vec3(0, -1, 0); break; // Down
             default:
-                return; // Not a rotation key
+                return false; // Not a rotation key
         }
      
 
@@ -160,48 +178,32 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
         int bestIdx = mapping.index;
         int bestSign = mapping.sign;
 
-        //check for axis lock toggles
-        if(camera->isLocked(bestIdx, axisLocked)) {std::cout << "Locked wall:" << (bestIdx == 0 ? "X" : bestIdx == 1 ? "Y" : "Z") <<  std::endl;   return ;} else if(s_TurnAngle == 45.0f) camera->SwitchLockedAxisState(bestIdx, bestSign, axisLocked);
-        
-
-        // 4. Apply the rotation to the identified local face
+        // 4. Queue the rotation of the identified local face. It plays once the turns queued before it
+        // allow, and is dropped then if a face left at 45 degrees locks its axis
         // We rotate around the local axis (X, Y, or Z)
-        glm::vec3 localRotationAxis(0.0f);
-        localRotationAxis[bestIdx] = 1.0f;
-
-
-        //turns all
-
-
-
-        // Start the animation
-        g_rotationAnimation.axis = localRotationAxis;
-        g_rotationAnimation.axisIndex = bestIdx;
-        g_rotationAnimation.posValue = bestSign;
-        g_rotationAnimation.targetAngle = baseAngle * bestSign;
-        g_rotationAnimation.currentAngle = 0.0f;
-        g_rotationAnimation.movingCubieIndices.clear();
-        for (size_t i = 0; i < g_cubieMatrices.size(); i++) {
-            if (glm::abs(g_cubieMatrices[i][3][bestIdx] - bestSign) < 0.1f) {
-                g_rotationAnimation.movingCubieIndices.push_back(i);
-            }
-        }
-        g_rotationAnimation.active = true;
-        
+        int depth = glm::min(s_LayerDepth, g_cube.GetSize());
+        return QueueFaceRotation({ bestIdx, bestSign > 0 ? g_cube.GetSize() - depth : depth - 1, baseEighths * bestSign });
     }
+    return false;
 }
-//checks if axis is locked
-bool Camera::isLocked(int axisIndex, bool axisLocked[3][2]) {
-    return axisLocked[(axisIndex + 1) % 3][0] ||
-    axisLocked[(axisIndex + 2) % 3][0] ||
-    axisLocked[(axisIndex + 1) % 3][1] ||
-    axisLocked[(axisIndex + 2) % 3][1];
+
+void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    PROFILE_SCOPE("KeyCallback");
+    // Stamped before anything else, the handling is part of the latency
+    const uint64_t pressed = InputLatency::Now();
+    Camera* camera = (Camera*) glfwGetWindowUserPointer(window);
+    if (!camera) {
+        std::cout << "Warning: Camera wasn't set as the Window User Pointer! KeyCallback is skipped" << std::endl;
+        return;
+    }
+
+    const bool turned = HandleKey(window, camera, key, action, mods);
+    InputLatency::RecordKey(key, action, pressed, turned ? GetQueuedTurnCount() : 0);
 }
-void Camera::SwitchLockedAxisState(int axisIndex, int sign, bool axisLocked[3][2]) {
-    axisLocked[axisIndex][sign > 0 ? 0 : 1] = !axisLocked[axisIndex][sign > 0 ? 0 : 1];
-}  
 void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 {
+    PROFILE_SCOPE("MouseButtonCallback");
     Camera* camera = (Camera*)glfwGetWindowUserPointer(window);
     if (!camera) return;
 
@@ -220,6 +222,7 @@ void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 
 void CursorPosCallback(GLFWwindow* window, double currMouseX, double currMouseY)
 {
+    PROFILE_SCOPE("CursorPosCallback");
     Camera* camera = (Camera*) glfwGetWindowUserPointer(window);
     if (!camera) {
         std::cout << "Warning: Camera wasn't set as the Window User Pointer! KeyCallback is skipped" << std::endl;
@@ -233,6 +236,7 @@ void CursorPosCallback(GLFWwindow* window, double currMouseX, double currMouseY)
 
 void ScrollCallback(GLFWwindow* window, double scrollOffsetX, double scrollOffsetY)
 {
+    PROFILE_SCOPE("ScrollCallback");
     Camera* camera = (Camera*) glfwGetWindowUserPointer(window);
     if (!camera) {
         std::cout << "Warning: Camera wasn't set as the Window User Pointer! ScrollCallback is skipped" << std::endl;
@@ -11,6 +11,7 @@
 #include <glm/gtx/vector_angle.hpp>
 #include <Debugger.h>
 #include <Shader.h>
+#include <UniformBuffer.h>
 
 //added 
 #include "CubeFaceRotations.h"
@@ -45,14 +46,16 @@ class Camera
         float m_RotationX = 45.0f;
         float m_RotationY = 45.0f;
 
+        // Scroll zoom limits on the camera distance
+        float m_MinZoom = 2.0f;
+        float m_MaxZoom = 50.0f;
+
 
 
 
 
     public:
 
-        bool isLocked(int axisIndex, bool axisLocked[3][2]);
-        void SwitchLockedAxisState(int axisIndex, int sign, bool axisLocked[3][2]);
      struct AxisMapping {
             int index; // 0 for X, 1 for Y, 2 for Z
             int sign; // 1 or -1
@@ -69,6 +72,11 @@ class Camera
         // Update Projection matrix for Perspective mode
         void SetPerspective(float fovDegree, float near, float far);
 
+        // This frame's view, projection and time, as the shared uniform block holds them
+        FrameConstants GetFrameConstants(float time) const;
+        // Upload them to the shared uniform block
+        void UpdateFrameConstants(UniformBuffer& frameConstants, float time) const;
+
         // Handle camera inputs
         void EnableInputs(GLFWwindow* window);
 
@@ -84,6 +92,8 @@ class Camera
         AxisMapping GetWorldToLocalMapping(glm::vec3 worldDir) const;
 
         inline void SetPosition(glm::vec3 position) { m_Position = position; UpdateViewMatrix(); }
+        inline void SetZoomRange(float minZoom, float maxZoom) { m_MinZoom = minZoom; m_MaxZoom = maxZoom; }
+        inline void SetRotation(float rotationX, float rotationY) { m_RotationX = rotationX; m_RotationY = rotationY; UpdateViewMatrix(); }
         inline void SetMousePosition(double x, double y) { m_OldMouseX = x; m_OldMouseY = y; }
         inline glm::mat4 GetViewMatrix() const { return m_View; }
         inline glm::mat4 GetProjectionMatrix() const { return m_Projection; }
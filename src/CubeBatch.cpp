@@ -0,0 +1,284 @@
+#include <CubeBatch.h>
+#include <Debugger.h>
+
+#include <algorithm>
+#include <cstring>
+
+// The SIMD paths are compiled for their instruction set function by function and only
+// called after checking the CPU, so the rest of the build stays baseline x86
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CUBE_BATCH_X86 1
+#include <immintrin.h>
+#else
+#define CUBE_BATCH_X86 0
+#endif
+
+static const int EDGE_OFFSET = 16;
+
+// A move as byte shuffles: the byte (within its 16-byte half) each slot takes its piece
+// from, then the twist added to it. Unused bytes keep their own value.
+struct alignas(32) PackedMove
+{
+    unsigned char shuffle[32];
+    unsigned char twist[32];
+};
+
+// Twists wrap at 3 for corners and 2 for edges: after the add, min(x, x - limit) takes the
+// limit off exactly when x reached it, since below the limit x - limit wraps to above x
+alignas(32) static const unsigned char s_TwistLimits[32] = {
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20
+};
+
+struct PackedMoves
+{
+    PackedMove moves[CubeState::MOVE_COUNT];
+
+    PackedMoves()
+    {
+        // A move applied to the solved cube says where every slot's piece comes from
+        for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+        {
+            CubeState turned;
+            turned.ApplyMove(move);
+            PackedMove& packed = moves[move];
+            for (int i = 0; i < 32; i++)
+            {
+                packed.shuffle[i] = (unsigned char)(i & 15);
+                packed.twist[i] = 0;
+            }
+            for (int slot = 0; slot < CubeState::CORNER_COUNT; slot++)
+            {
+                packed.shuffle[slot] = turned.cp[slot];
+                packed.twist[slot] = (unsigned char)(turned.co[slot] << 4);
+            }
+            for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+            {
+                packed.shuffle[EDGE_OFFSET + slot] = turned.ep[slot];
+                packed.twist[EDGE_OFFSET + slot] = (unsigned char)(turned.eo[slot] << 4);
+            }
+        }
+    }
+};
+
+static const PackedMove* GetPackedMoves()
+{
+    static const PackedMoves packed;
+    return packed.moves;
+}
+
+PackedCube::PackedCube()
+{
+    for (int i = 0; i < 32; i++)
+        bytes[i] = (unsigned char)(i & 15);
+}
+
+PackedCube::PackedCube(const CubeState& state)
+    : PackedCube()
+{
+    for (int slot = 0; slot < CubeState::CORNER_COUNT; slot++)
+        bytes[slot] = (unsigned char)(state.cp[slot] | state.co[slot] << 4);
+    for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+        bytes[EDGE_OFFSET + slot] = (unsigned char)(state.ep[slot] | state.eo[slot] << 4);
+}
+
+CubeState PackedCube::ToState() const
+{
+    CubeState state;
+    for (int slot = 0; slot < CubeState::CORNER_COUNT; slot++)
+    {
+        state.cp[slot] = bytes[slot] & 15;
+        state.co[slot] = bytes[slot] >> 4;
+    }
+    for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+    {
+        state.ep[slot] = bytes[EDGE_OFFSET + slot] & 15;
+        state.eo[slot] = bytes[EDGE_OFFSET + slot] >> 4;
+    }
+    return state;
+}
+
+bool PackedCube::IsSolved() const
+{
+    static const PackedCube s_Solved;
+    return std::memcmp(bytes, s_Solved.bytes, sizeof(bytes)) == 0;
+}
+
+// Cube i takes moves[i * stride] to moves[i * stride + length - 1]; a stride of 0 gives every cube the same moves
+static void ApplyScalar(PackedCube* cubes, size_t count, const unsigned char* moves, size_t length, size_t stride)
+{
+    const PackedMove* table = GetPackedMoves();
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char* bytes = cubes[i].bytes;
+        const unsigned char* sequence = moves + i * stride;
+        for (size_t k = 0; k < length; k++)
+        {
+            const PackedMove& move = table[sequence[k]];
+            // Only the bytes that hold pieces, with the same twist arithmetic as the SIMD paths
+            unsigned char corners[CubeState::CORNER_COUNT], edges[CubeState::EDGE_COUNT];
+            for (int slot = 0; slot < CubeState::CORNER_COUNT; slot++)
+            {
+                const unsigned char twisted = (unsigned char)(bytes[move.shuffle[slot]] + move.twist[slot]);
+                corners[slot] = std::min(twisted, (unsigned char)(twisted - s_TwistLimits[slot]));
+            }
+            for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+                edges[slot] = bytes[EDGE_OFFSET + move.shuffle[EDGE_OFFSET + slot]] ^ move.twist[EDGE_OFFSET + slot];
+            std::memcpy(bytes, corners, sizeof(corners));
+            std::memcpy(bytes + EDGE_OFFSET, edges, sizeof(edges));
+        }
+    }
+}
+
+#if CUBE_BATCH_X86
+
+__attribute__((target("ssse3")))
+static void ApplySSSE3(PackedCube* cubes, size_t count, const unsigned char* moves, size_t length, size_t stride)
+{
+    const PackedMove* table = GetPackedMoves();
+    const __m128i cornerLimits = _mm_load_si128((const __m128i*)s_TwistLimits);
+    const __m128i edgeLimits = _mm_load_si128((const __m128i*)(s_TwistLimits + EDGE_OFFSET));
+    for (size_t i = 0; i < count; i++)
+    {
+        __m128i corners = _mm_load_si128((const __m128i*)cubes[i].bytes);
+        __m128i edges = _mm_load_si128((const __m128i*)(cubes[i].bytes + EDGE_OFFSET));
+        const unsigned char* sequence = moves + i * stride;
+        for (size_t k = 0; k < length; k++)
+        {
+            const PackedMove& move = table[sequence[k]];
+            corners = _mm_shuffle_epi8(corners, _mm_load_si128((const __m128i*)move.shuffle));
+            edges = _mm_shuffle_epi8(edges, _mm_load_si128((const __m128i*)(move.shuffle + EDGE_OFFSET)));
+            corners = _mm_add_epi8(corners, _mm_load_si128((const __m128i*)move.twist));
+            edges = _mm_add_epi8(edges, _mm_load_si128((const __m128i*)(move.twist + EDGE_OFFSET)));
+            corners = _mm_min_epu8(corners, _mm_sub_epi8(corners, cornerLimits));
+            edges = _mm_min_epu8(edges, _mm_sub_epi8(edges, edgeLimits));
+        }
+        _mm_store_si128((__m128i*)cubes[i].bytes, corners);
+        _mm_store_si128((__m128i*)(cubes[i].bytes + EDGE_OFFSET), edges);
+    }
+}
+
+__attribute__((target("avx2")))
+static void ApplyAVX2(PackedCube* cubes, size_t count, const unsigned char* moves, size_t length, size_t stride)
+{
+    const PackedMove* table = GetPackedMoves();
+    const __m256i limits = _mm256_load_si256((const __m256i*)s_TwistLimits);
+    // Two cubes at a time: each move is a chain of dependent instructions, two chains keep the CPU busy
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256i first = _mm256_load_si256((const __m256i*)cubes[i].bytes);
+        __m256i second = _mm256_load_si256((const __m256i*)cubes[i + 1].bytes);
+        const unsigned char* firstSequence = moves + i * stride;
+        const unsigned char* secondSequence = firstSequence + stride;
+        for (size_t k = 0; k < length; k++)
+        {
+            const PackedMove& firstMove = table[firstSequence[k]];
+            const PackedMove& secondMove = table[secondSequence[k]];
+            first = _mm256_shuffle_epi8(first, _mm256_load_si256((const __m256i*)firstMove.shuffle));
+            second = _mm256_shuffle_epi8(second, _mm256_load_si256((const __m256i*)secondMove.shuffle));
+            first = _mm256_add_epi8(first, _mm256_load_si256((const __m256i*)firstMove.twist));
+            second = _mm256_add_epi8(second, _mm256_load_si256((const __m256i*)secondMove.twist));
+            first = _mm256_min_epu8(first, _mm256_sub_epi8(first, limits));
+            second = _mm256_min_epu8(second, _mm256_sub_epi8(second, limits));
+        }
+        _mm256_store_si256((__m256i*)cubes[i].bytes, first);
+        _mm256_store_si256((__m256i*)cubes[i + 1].bytes, second);
+    }
+    for (; i < count; i++)
+    {
+        __m256i cube = _mm256_load_si256((const __m256i*)cubes[i].bytes);
+        const unsigned char* sequence = moves + i * stride;
+        for (size_t k = 0; k < length; k++)
+        {
+            const PackedMove& move = table[sequence[k]];
+            cube = _mm256_shuffle_epi8(cube, _mm256_load_si256((const __m256i*)move.shuffle));
+            cube = _mm256_add_epi8(cube, _mm256_load_si256((const __m256i*)move.twist));
+            cube = _mm256_min_epu8(cube, _mm256_sub_epi8(cube, limits));
+        }
+        _mm256_store_si256((__m256i*)cubes[i].bytes, cube);
+    }
+}
+
+#endif
+
+static void Apply(CubeBatch::Backend backend, PackedCube* cubes, size_t count, const unsigned char* moves, size_t length, size_t stride)
+{
+    switch (backend)
+    {
+#if CUBE_BATCH_X86
+        case CubeBatch::Backend::AVX2:
+            ApplyAVX2(cubes, count, moves, length, stride);
+            return;
+        case CubeBatch::Backend::SSSE3:
+            ApplySSSE3(cubes, count, moves, length, stride);
+            return;
+#endif
+        default:
+            ApplyScalar(cubes, count, moves, length, stride);
+            return;
+    }
+}
+
+CubeBatch::CubeBatch(size_t count, Backend backend)
+    : m_Cubes(count), m_Backend(GetSupportedBackend(backend))
+{
+}
+
+void CubeBatch::Reset()
+{
+    std::fill(m_Cubes.begin(), m_Cubes.end(), PackedCube());
+}
+
+void CubeBatch::ApplyMove(int move)
+{
+    ASSERT(move >= 0 && move < CubeState::MOVE_COUNT);
+    const unsigned char packed = (unsigned char)move;
+    Apply(m_Backend, m_Cubes.data(), m_Cubes.size(), &packed, 1, 0);
+}
+
+void CubeBatch::ApplyMoves(const std::vector<int>& moves)
+{
+    std::vector<unsigned char> packed(moves.size());
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        ASSERT(moves[i] >= 0 && moves[i] < CubeState::MOVE_COUNT);
+        packed[i] = (unsigned char)moves[i];
+    }
+    Apply(m_Backend, m_Cubes.data(), m_Cubes.size(), packed.data(), packed.size(), 0);
+}
+
+void CubeBatch::ApplySequences(const unsigned char* moves, size_t length)
+{
+    Apply(m_Backend, m_Cubes.data(), m_Cubes.size(), moves, length, length);
+}
+
+size_t CubeBatch::CountSolved() const
+{
+    size_t solved = 0;
+    for (const PackedCube& cube : m_Cubes)
+        solved += cube.IsSolved();
+    return solved;
+}
+
+CubeBatch::Backend CubeBatch::GetSupportedBackend(Backend requested)
+{
+#if CUBE_BATCH_X86
+    if ((requested == Backend::Best || requested == Backend::AVX2) && __builtin_cpu_supports("avx2"))
+        return Backend::AVX2;
+    if (requested != Backend::Scalar && __builtin_cpu_supports("ssse3"))
+        return Backend::SSSE3;
+#endif
+    return Backend::Scalar;
+}
+
+std::string CubeBatch::GetBackendName(Backend backend)
+{
+    switch (backend)
+    {
+        case Backend::AVX2: return "avx2";
+        case Backend::SSSE3: return "ssse3";
+        case Backend::Scalar: return "scalar";
+        default: return "best";
+    }
+}
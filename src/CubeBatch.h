@@ -0,0 +1,61 @@
+#pragma once
+
+#include <CubeState.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// One 3x3x3 cube in 32 bytes, laid out for byte shuffles: the corner slots in
+// bytes 0-7, the edge slots in bytes 16-27, each holding piece | twist << 4.
+// The corners and the edges sit in separate 16-byte halves, so one SSSE3 pshufb
+// per half, or a single AVX2 vpshufb (which shuffles each half on its own),
+// moves every piece of the cube at once.
+struct alignas(32) PackedCube
+{
+    unsigned char bytes[32];
+
+    // Solved
+    PackedCube();
+    explicit PackedCube(const CubeState& state);
+    CubeState ToState() const;
+    bool IsSolved() const;
+};
+
+// Many cubes turned together, for scramble generation and analysis where
+// CubeState's one-cube-at-a-time moves are too slow. A move is a shuffle, an
+// add and a min per cube. The widest instruction set the CPU has is picked
+// at run time; the scalar path gives the same results anywhere.
+class CubeBatch
+{
+    public:
+        enum class Backend { Scalar, SSSE3, AVX2, Best };
+    private:
+        std::vector<PackedCube> m_Cubes;
+        Backend m_Backend;
+    public:
+        // count solved cubes
+        explicit CubeBatch(size_t count = 0, Backend backend = Backend::Best);
+
+        inline size_t GetSize() const { return m_Cubes.size(); }
+        inline Backend GetBackend() const { return m_Backend; }
+        inline PackedCube& operator[](size_t index) { return m_Cubes[index]; }
+        inline const PackedCube& operator[](size_t index) const { return m_Cubes[index]; }
+        inline PackedCube* GetData() { return m_Cubes.data(); }
+
+        // Every cube back to solved
+        void Reset();
+
+        // The same moves (CubeState numbering) on every cube
+        void ApplyMove(int move);
+        void ApplyMoves(const std::vector<int>& moves);
+        // A sequence of its own on every cube: cube i takes moves[i * length] to moves[i * length + length - 1].
+        // Unchecked, every move has to be below CubeState::MOVE_COUNT
+        void ApplySequences(const unsigned char* moves, size_t length);
+
+        size_t CountSolved() const;
+
+        // Best resolves to the widest backend this CPU runs; asking for one it lacks falls back the same way
+        static Backend GetSupportedBackend(Backend requested = Backend::Best);
+        static std::string GetBackendName(Backend backend);
+};
@@ -0,0 +1,366 @@
+#include <CubeFaceRotations.h>
+#include <CubeState.h>
+#include <Debugger.h>
+#include <InputLatency.h>
+#include <OptimalSolver.h>
+#include <TwoPhaseSolver.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+
+CubeGrid g_cube;
+
+// Current transformation matrix of every surface cubie, in CubeGrid slot order
+std::vector<glm::mat4> g_cubieMatrices;
+// Bumped whenever g_cubieMatrices changes, so snapshots copy them only then
+static uint64_t s_MatricesVersion = 1;
+
+// Global animation state
+RotationAnimation g_rotationAnimation;
+MoveQueue g_moveQueue;
+MoveSequence g_pendingTurns;
+
+// Simulated time, the sum of every UpdateAnimation step: what recorded turns are stamped with
+static double s_Time = 0.0;
+static MoveLogWriter* s_Recording = nullptr;
+
+// The replay in progress: the log, how far into it playback is (in recorded time), and the next turn due
+static MoveLogReader* s_Replay = nullptr;
+static float s_ReplaySpeed = 1.0f;
+static double s_ReplayTime = 0.0;
+static LoggedTurn s_NextReplayed;
+
+// Turns started so far, to tell whether the cube moved while a solution was searched for
+static uint64_t s_TurnCount = 0;
+// Turns pushed onto the move queue (input side) and taken off it (simulation side). A turn's
+// number in that order is its id in g_pendingTurns
+static uint64_t s_QueuedTurns = 0;
+static uint64_t s_TakenTurns = 0;
+// Solve asked for from the input thread (0 none, 1 two-phase, 2 optimal), picked up by UpdateAnimation
+static std::atomic<int> s_SolutionRequest(0);
+// The search running in the background, and the turn count when it started
+static std::future<std::vector<LayerTurn>> s_Solution;
+static uint64_t s_SolutionTurnCount = 0;
+
+void InitCubies(int size)
+{
+    g_cube = CubeGrid(size);
+    g_rotationAnimation.layers.clear();
+    g_rotationAnimation.active = false;
+    while (!g_moveQueue.IsEmpty())
+    {
+        g_moveQueue.Pop();
+        s_TakenTurns++;
+    }
+    g_pendingTurns.Clear();
+    s_Replay = nullptr;
+    g_cube.GetCubieMatrices(g_cubieMatrices);
+    s_MatricesVersion++;
+}
+
+bool QueueFaceRotation(const LayerTurn& turn)
+{
+    if (g_moveQueue.Push(turn))
+    {
+        s_QueuedTurns++;
+        return true;
+    }
+    std::cout << "Move queue full, turn dropped" << std::endl;
+    return false;
+}
+
+uint64_t GetQueuedTurnCount()
+{
+    return s_QueuedTurns;
+}
+
+bool CanStartFaceRotation(const LayerTurn& turn)
+{
+    const std::vector<LayerAnimation>& layers = g_rotationAnimation.layers;
+    if (layers.empty())
+        return true;
+    if (turn.axisIndex != layers[0].turn.axisIndex || layers.size() >= MAX_TURNING_LAYERS)
+        return false;
+    for (const LayerAnimation& layer : layers)
+    {
+        if (layer.turn.layer == turn.layer)
+            return false;
+    }
+    return true;
+}
+
+void StartFaceRotation(const LayerTurn& turn)
+{
+    ASSERT(!g_cube.IsAxisBlocked(turn.axisIndex));
+    ASSERT(CanStartFaceRotation(turn));
+
+    glm::vec3 localRotationAxis(0.0f);
+    localRotationAxis[turn.axisIndex] = 1.0f;
+    g_rotationAnimation.axis = localRotationAxis;
+
+    // Straight from the layer index, without looking at the matrices
+    LayerAnimation layer;
+    layer.turn = turn;
+    layer.slots = g_cube.GetLayerSlots(turn.axisIndex, turn.layer);
+    layer.startAngle = 0.0f;
+    layer.currentAngle = 0.0f;
+    layer.targetAngle = glm::radians(45.0f * turn.eighthTurns);
+    g_rotationAnimation.layers.push_back(layer);
+    g_rotationAnimation.active = true;
+    s_TurnCount++;
+
+    if (s_Recording)
+        s_Recording->Append(turn, s_Time);
+}
+
+void RecordTurns(MoveLogWriter* log)
+{
+    ASSERT(!log || log->GetCubeSize() == g_cube.GetSize());
+    s_Recording = log;
+}
+
+void ReplayTurns(MoveLogReader* log, float speed)
+{
+    ASSERT(log->GetCubeSize() == g_cube.GetSize());
+    ASSERT(!g_rotationAnimation.active);
+    log->Rewind();
+    if (speed > 0.0f)
+    {
+        s_Replay = log->Next(s_NextReplayed) ? log : nullptr;
+        s_ReplaySpeed = speed;
+        s_ReplayTime = 0.0;
+        return;
+    }
+
+    // Every logged turn was free to start when it did, so the same turns in the same order land
+    // the same way without looking at axes and animations
+    const auto start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    LoggedTurn logged;
+    while (log->Next(logged))
+    {
+        g_cube.ApplyTurn(logged.turn);
+        count++;
+    }
+    g_cube.GetCubieMatrices(g_cubieMatrices);
+    s_MatricesVersion++;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Replayed " << count << " turns in " << seconds * 1000.0 << " ms" << std::endl;
+    if (!log->IsAtEnd())
+        std::cout << "The move log is damaged past that point" << std::endl;
+}
+
+bool IsReplaying()
+{
+    return s_Replay != nullptr;
+}
+
+static const TwoPhaseSolver& GetSolver()
+{
+    // Built, or loaded from its cache file, the first time a solve is asked for
+    static const TwoPhaseSolver solver;
+    return solver;
+}
+
+static const OptimalSolver& GetOptimalSolver()
+{
+    // Maps the pattern databases, reading nothing yet
+    static const OptimalSolver solver;
+    return solver;
+}
+
+void QueueSolution(bool optimal)
+{
+    s_SolutionRequest.store(optimal ? 2 : 1);
+}
+
+// Start the search for a solution of the current cube in the background, see QueueSolution
+static void StartSolution(bool optimal)
+{
+    if (g_cube.GetSize() != 3)
+    {
+        std::cout << "The solver only handles 3x3x3 cubes" << std::endl;
+        return;
+    }
+    if (s_Solution.valid())
+    {
+        std::cout << "Still looking for the last solution" << std::endl;
+        return;
+    }
+    if (g_rotationAnimation.active || !g_moveQueue.IsEmpty() || !g_pendingTurns.IsEmpty())
+    {
+        std::cout << "Let the queued turns finish before solving" << std::endl;
+        return;
+    }
+
+    // The solver sees the cube through its stickers, so slice turns that moved the centers are fine
+    std::string facelets;
+    CubeState state;
+    if (!g_cube.GetFacelets(facelets) || !CubeState::FromFacelets(facelets, state))
+    {
+        std::cout << "Square up every layer before solving" << std::endl;
+        return;
+    }
+    if (optimal && !GetOptimalSolver().IsLoaded())
+    {
+        std::cout << "Pattern databases missing from pdb/, build them with make pdb" << std::endl;
+        return;
+    }
+
+    // The optimal search can take seconds, the simulation keeps stepping meanwhile
+    s_SolutionTurnCount = s_TurnCount;
+    s_Solution = std::async(std::launch::async, [state, optimal]()
+    {
+        std::vector<LayerTurn> turns;
+        std::vector<int> moves;
+        if (optimal)
+        {
+            if (!GetOptimalSolver().Solve(state, moves, 0, 30000.0))
+            {
+                std::cout << "No optimal solution within 30 s" << std::endl;
+                return turns;
+            }
+        }
+        else if (!GetSolver().Solve(state, moves, 20, 1000.0))
+        {
+            std::cout << "No solution of 20 moves or fewer within 1 s" << std::endl;
+            return turns;
+        }
+        std::string text;
+        for (int move : moves)
+            text += CubeState::MoveName(move) + " ";
+        std::cout << "Solution (" << moves.size() << " moves): " << text << std::endl;
+        CubeGrid::ParseMoves(text, 3, turns);
+        return turns;
+    });
+}
+
+// Queue the turns of a finished search, unless the cube moved since it started
+static void CollectSolution()
+{
+    if (!s_Solution.valid() || s_Solution.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+    const std::vector<LayerTurn> turns = s_Solution.get();
+    if (s_TurnCount != s_SolutionTurnCount)
+    {
+        std::cout << "The cube was turned while solving, solution dropped" << std::endl;
+        return;
+    }
+    for (const LayerTurn& turn : turns)
+        g_pendingTurns.Push(turn);
+}
+
+void TakeSnapshot(CubeSnapshot& snapshot)
+{
+    if (snapshot.matricesVersion != s_MatricesVersion)
+    {
+        snapshot.cubieMatrices = g_cubieMatrices;
+        snapshot.matricesVersion = s_MatricesVersion;
+    }
+    snapshot.axis = g_rotationAnimation.axis;
+    // Turns older than every one still pending have started, or were merged, cancelled or dropped
+    const uint64_t oldestPending = g_pendingTurns.GetOldestId();
+    snapshot.turnsSettled = oldestPending ? oldestPending - 1 : s_TakenTurns;
+    snapshot.layers.clear();
+    for (const LayerAnimation& layer : g_rotationAnimation.layers)
+        snapshot.layers.push_back({ layer.slots, layer.startAngle, layer.currentAngle });
+}
+
+void UpdateAnimation(float deltaTime, CubeSnapshot* snapshot) {
+    s_Time += deltaTime;
+
+    // Replayed turns that have come due go straight to the pending turns, the move queue is the input thread's
+    if (s_Replay)
+    {
+        s_ReplayTime += deltaTime * s_ReplaySpeed;
+        while (s_NextReplayed.time <= s_ReplayTime)
+        {
+            g_pendingTurns.Push(s_NextReplayed.turn);
+            if (!s_Replay->Next(s_NextReplayed))
+            {
+                if (!s_Replay->IsAtEnd())
+                    std::cout << "The move log is damaged past this point" << std::endl;
+                s_Replay = nullptr;
+                break;
+            }
+        }
+    }
+
+    // Everything queued joins the pending turns, where it merges with or cancels what came before
+    LayerTurn turn;
+    while (g_moveQueue.Peek(turn))
+    {
+        g_pendingTurns.Push(turn, ++s_TakenTurns);
+        g_moveQueue.Pop();
+    }
+    CollectSolution();
+
+    // Start pending turns in order for as long as they fit next to the running ones; the first
+    // that doesn't waits, so turns that don't commute always land in the order they were queued
+    while (!g_pendingTurns.IsEmpty())
+    {
+        turn = g_pendingTurns.Front();
+        if (g_rotationAnimation.active && turn.axisIndex != g_rotationAnimation.layers[0].turn.axisIndex)
+            break;
+        // A face left at 45 degrees locks the other two axes until it is squared up again
+        if (g_cube.IsAxisBlocked(turn.axisIndex))
+        {
+            std::cout << "Locked wall:" << (turn.axisIndex == 0 ? "X" : turn.axisIndex == 1 ? "Y" : "Z") << std::endl;
+            g_pendingTurns.PopFront();
+            continue;
+        }
+        if (!CanStartFaceRotation(turn))
+            break;
+        const uint64_t id = g_pendingTurns.GetFrontId();
+        g_pendingTurns.PopFront();
+        StartFaceRotation(turn);
+        if (id)
+            InputLatency::TurnStarted(id);
+    }
+
+    const int solutionRequest = s_SolutionRequest.exchange(0);
+    if (solutionRequest)
+        StartSolution(solutionRequest == 2);
+
+    if (!g_rotationAnimation.active)
+    {
+        if (snapshot)
+            TakeSnapshot(*snapshot);
+        return;
+    }
+
+    // Every turn still waiting adds one turn's worth of speed, up to the cap
+    const float speedup = std::min(1.0f + g_pendingTurns.GetSize(), g_rotationAnimation.maxSpeedup);
+    const float step = g_rotationAnimation.speed * speedup * deltaTime;
+
+    std::vector<LayerAnimation>& layers = g_rotationAnimation.layers;
+    for (LayerAnimation& layer : layers)
+    {
+        float dir = (layer.targetAngle > 0) ? 1.0f : -1.0f;
+        layer.startAngle = layer.currentAngle;
+        layer.currentAngle += dir * step;
+        if (glm::abs(layer.currentAngle) >= glm::abs(layer.targetAngle))
+            layer.currentAngle = layer.targetAngle;
+    }
+    if (snapshot)
+        TakeSnapshot(*snapshot);
+
+    for (size_t i = 0; i < layers.size();)
+    {
+        LayerAnimation& layer = layers[i];
+        if (layer.currentAngle != layer.targetAngle) {
+            i++;
+            continue;
+        }
+
+        // Layer finished: commit the turn to the state and refresh the turned layer's matrices
+        g_cube.ApplyTurn(layer.turn);
+        g_cube.UpdateCubieMatrices(g_cubieMatrices, layer.turn.axisIndex, layer.turn.layer);
+        s_MatricesVersion++;
+        layers.erase(layers.begin() + i);
+    }
+    g_rotationAnimation.active = !layers.empty();
+}
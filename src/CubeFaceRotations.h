@@ -1,19 +1,107 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 
+#include <CubeGrid.h>
+#include <MoveLog.h>
+#include <MoveQueue.h>
+#include <MoveSequence.h>
+
+// Logical cube state, the cubie matrices below are derived from it
+extern CubeGrid g_cube;
 extern std::vector<glm::mat4> g_cubieMatrices;
 
+// Most layers that turn at once (the instanced shader has one batch per layer, plus the resting cubies)
+static const int MAX_TURNING_LAYERS = 8;
+
+// One layer on its way through a turn
+struct LayerAnimation {
+    LayerTurn turn;
+    CubeGrid::LayerSlots slots;
+    float startAngle; // Where the current simulation step found it
+    float currentAngle;
+    float targetAngle;
+};
+
+// Layers turning together, all on the same axis and each at most once, so they
+// never share a cubie and their turns commute
 struct RotationAnimation {
     bool active = false;
     glm::vec3 axis;
-    int axisIndex;
-    float posValue;
-    float currentAngle = 0.0f;
-    float targetAngle = 0.0f;
     float speed = 10.0f; // Radians per second
-    std::vector<size_t> movingCubieIndices;
+    float maxSpeedup = 8.0f; // A backlog of queued moves speeds every turn up, to at most this factor
+    std::vector<LayerAnimation> layers;
 };
 extern RotationAnimation g_rotationAnimation;
 
-void RotateFace(glm::vec3 axis, int axisIndex, float posValue, float angle);
\ No newline at end of file
+// A turning layer as a snapshot holds it: its angle at the start and at the end of the step
+struct TurningLayer {
+    CubeGrid::LayerSlots slots;
+    float startAngle;
+    float endAngle;
+};
+
+// What the renderer needs of one simulation step, copied out of the live state so
+// the simulation can step on while a frame draws it. Layers that landed in the step
+// are still listed (ending on their target angle) and their cubies' matrices are the
+// ones from before the turn, so drawing anywhere in the step needs no other state
+struct CubeSnapshot {
+    std::vector<glm::mat4> cubieMatrices;
+    uint64_t matricesVersion = 0; // Which version of g_cubieMatrices they are a copy of
+    glm::vec3 axis = glm::vec3(1.0f, 0.0f, 0.0f);
+    std::vector<TurningLayer> layers;
+    double time = 0.0; // Simulated time at the end of the step
+    uint64_t turnsSettled = 0; // Turns off g_moveQueue that either started or never will, see GetQueuedTurnCount
+
+    // A layer's angle at alpha (0 to 1) of the way through the step
+    inline float GetAngle(const TurningLayer& layer, float alpha) const
+    {
+        return layer.startAngle + (layer.endAngle - layer.startAngle) * alpha;
+    }
+};
+
+// Input side of the simulation: key callbacks and scripts push, UpdateAnimation pops
+extern MoveQueue g_moveQueue;
+// Turns taken off the queue and not started yet, kept canonical so redundant input
+// (R R R, R R') never reaches the animation
+extern MoveSequence g_pendingTurns;
+
+// Reset to a solved size x size x size cube
+void InitCubies(int size);
+
+// Queue one layer turn, see LayerTurn. False when the queue is full and the turn is dropped
+bool QueueFaceRotation(const LayerTurn& turn);
+// Turns QueueFaceRotation got into the queue so far; a snapshot with as many turnsSettled has started
+// every one of them that it ever will
+uint64_t GetQueuedTurnCount();
+
+// True when the turn can start right away, alongside whatever is already turning
+bool CanStartFaceRotation(const LayerTurn& turn);
+// Animate one layer turn now, bypassing the queue
+void StartFaceRotation(const LayerTurn& turn);
+
+// Ask the simulation to solve the cube and play the solution's turns: with the two-phase solver,
+// or with the optimal solver (which needs the pattern databases from make pdb and can take seconds).
+// Safe from the input thread. The next UpdateAnimation starts the search in the background, for
+// a 3x3x3 cube with every turn landed (a message says otherwise), and the turns are queued once it
+// is done, unless the cube was turned in the meantime
+void QueueSolution(bool optimal = false);
+
+// Record every turn into log as it starts, from now on (nullptr stops recording). The log has to
+// be for the cube's size and stay alive while it records
+void RecordTurns(MoveLogWriter* log);
+
+// Play a log's turns back from the start: through the move queue at speed times the pace they were
+// recorded at, or with speed 0 straight onto the cube, all at once and without animation. The log
+// has to be for the cube's size and stay alive while it plays (only the instant replay is over on return)
+void ReplayTurns(MoveLogReader* log, float speed);
+bool IsReplaying();
+
+// Copy what the renderer needs of the current state, see CubeSnapshot. The cubie matrices are
+// only copied when they changed since the snapshot last held them
+void TakeSnapshot(CubeSnapshot& snapshot);
+
+// Move queued turns into the pending sequence, start the pending turns that can run now, advance every turning layer and commit the finished ones to the cube state.
+// With a snapshot, it is taken after the layers moved and before the finished ones are committed
+void UpdateAnimation(float deltaTime, CubeSnapshot* snapshot = nullptr);
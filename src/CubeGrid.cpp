@@ -0,0 +1,438 @@
+#include <CubeGrid.h>
+#include <CubeState.h>
+#include <Debugger.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cctype>
+#include <sstream>
+
+// The 24 rotations of a cube as integer matrices, index 0 being the identity
+struct CubeRotations
+{
+    static const int COUNT = 24;
+
+    int matrices[COUNT][3][3];
+    unsigned char compose[COUNT][COUNT]; // compose[a][b]: b, then a
+    unsigned char quarterTurns[3];       // 90 degrees counter-clockwise about each positive axis
+    glm::mat3 floatMatrices[COUNT];
+
+    CubeRotations()
+    {
+        int count = 1;
+        SetIdentity(matrices[0]);
+        static const int s_Quarter[3][3][3] = {
+            { { 1, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 } },
+            { { 0, 0, 1 }, { 0, 1, 0 }, { -1, 0, 0 } },
+            { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } }
+        };
+
+        // Close the group under the three quarter turns
+        for (int i = 0; i < count; i++)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                int product[3][3];
+                Multiply(s_Quarter[axis], matrices[i], product);
+                if (Find(product, count) < 0)
+                {
+                    ASSERT(count < COUNT);
+                    Copy(product, matrices[count++]);
+                }
+            }
+        }
+        ASSERT(count == COUNT);
+
+        for (int a = 0; a < COUNT; a++)
+        {
+            for (int b = 0; b < COUNT; b++)
+            {
+                int product[3][3];
+                Multiply(matrices[a], matrices[b], product);
+                compose[a][b] = (unsigned char)Find(product, COUNT);
+            }
+            // glm is column major
+            for (int row = 0; row < 3; row++)
+                for (int column = 0; column < 3; column++)
+                    floatMatrices[a][column][row] = (float)matrices[a][row][column];
+        }
+        for (int axis = 0; axis < 3; axis++)
+            quarterTurns[axis] = (unsigned char)Find(s_Quarter[axis], COUNT);
+    }
+
+    int Find(const int m[3][3], int count) const
+    {
+        for (int i = 0; i < count; i++)
+        {
+            bool equal = true;
+            for (int row = 0; row < 3 && equal; row++)
+                for (int column = 0; column < 3 && equal; column++)
+                    equal = matrices[i][row][column] == m[row][column];
+            if (equal)
+                return i;
+        }
+        return -1;
+    }
+
+    static void SetIdentity(int m[3][3])
+    {
+        for (int row = 0; row < 3; row++)
+            for (int column = 0; column < 3; column++)
+                m[row][column] = row == column;
+    }
+
+    static void Copy(const int from[3][3], int to[3][3])
+    {
+        for (int row = 0; row < 3; row++)
+            for (int column = 0; column < 3; column++)
+                to[row][column] = from[row][column];
+    }
+
+    static void Multiply(const int a[3][3], const int b[3][3], int result[3][3])
+    {
+        for (int row = 0; row < 3; row++)
+        {
+            for (int column = 0; column < 3; column++)
+            {
+                result[row][column] = 0;
+                for (int k = 0; k < 3; k++)
+                    result[row][column] += a[row][k] * b[k][column];
+            }
+        }
+    }
+};
+
+static const CubeRotations& GetRotations()
+{
+    static const CubeRotations rotations;
+    return rotations;
+}
+
+CubeGrid::CubeGrid(int size)
+    : m_Size(size), m_RingSize(4 * (size - 1))
+{
+    ASSERT(size >= 2);
+    m_Orientations.assign(6 * size * size - 12 * size + 8, 0);
+    m_LayerOffsets.assign(3 * size, 0);
+    m_OffsetLayers[0] = m_OffsetLayers[1] = m_OffsetLayers[2] = 0;
+    BuildLayerIndex();
+}
+
+void CubeGrid::BuildLayerIndex()
+{
+    const CubeRotations& rotations = GetRotations();
+    const int n = m_Size;
+    m_LayerIndex.clear();
+    m_LayerIndex.reserve(3 * m_Orientations.size());
+    m_LayerStarts.assign(1, 0);
+    m_LayerFixed.clear();
+
+    // Each layer's surface slots are walked once; a slot not yet in a cycle starts a new one
+    std::vector<unsigned char> visited(m_Orientations.size(), 0);
+    std::vector<unsigned int> fixed;
+    for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+    {
+        const int (&quarter)[3][3] = rotations.matrices[rotations.quarterTurns[axisIndex]];
+        const int uAxis = (axisIndex + 1) % 3, vAxis = (axisIndex + 2) % 3;
+        for (int layer = 0; layer < n; layer++)
+        {
+            const size_t layerStart = m_LayerIndex.size();
+            fixed.clear();
+            auto visit = [&](int u, int v) {
+                glm::ivec3 position;
+                position[axisIndex] = layer;
+                position[uAxis] = u;
+                position[vAxis] = v;
+                const unsigned int slot = (unsigned int)GetSlotIndex(position.x, position.y, position.z);
+                if (visited[slot])
+                    return;
+
+                // Follow the slot around the axis in doubled coordinates, which stay integers for even sizes
+                unsigned int cycle[4];
+                glm::ivec3 centered = position * 2 - glm::ivec3(n - 1);
+                for (int i = 0; i < 4; i++)
+                {
+                    const glm::ivec3 at = (centered + glm::ivec3(n - 1)) / 2;
+                    cycle[i] = (unsigned int)GetSlotIndex(at.x, at.y, at.z);
+                    visited[cycle[i]] = 1;
+                    glm::ivec3 turned;
+                    for (int row = 0; row < 3; row++)
+                        turned[row] = quarter[row][0] * centered.x + quarter[row][1] * centered.y + quarter[row][2] * centered.z;
+                    centered = turned;
+                }
+                if (cycle[1] == cycle[0])
+                    fixed.push_back(cycle[0]);
+                else
+                    m_LayerIndex.insert(m_LayerIndex.end(), cycle, cycle + 4);
+            };
+
+            // Same walk as the slots are laid out: the whole face for outer layers, the ring otherwise
+            if (layer == 0 || layer == n - 1)
+            {
+                for (int u = 0; u < n; u++)
+                    for (int v = 0; v < n; v++)
+                        visit(u, v);
+            }
+            else
+            {
+                for (int v = 0; v < n; v++)
+                {
+                    visit(0, v);
+                    visit(n - 1, v);
+                }
+                for (int u = 1; u < n - 1; u++)
+                {
+                    visit(u, 0);
+                    visit(u, n - 1);
+                }
+            }
+
+            m_LayerFixed.push_back((unsigned int)m_LayerIndex.size());
+            m_LayerIndex.insert(m_LayerIndex.end(), fixed.begin(), fixed.end());
+            m_LayerStarts.push_back((unsigned int)m_LayerIndex.size());
+            for (size_t i = layerStart; i < m_LayerIndex.size(); i++)
+                visited[m_LayerIndex[i]] = 0;
+        }
+    }
+}
+
+size_t CubeGrid::GetSlotIndex(int x, int y, int z) const
+{
+    const int n = m_Size;
+    if (x == 0)
+        return (size_t)y * n + z;
+    if (x == n - 1)
+        return (size_t)n * n + (size_t)(n - 2) * m_RingSize + (size_t)y * n + z;
+
+    // Inner x layer: its y = 0 row, its y = n - 1 row, then both ends of every row between
+    size_t ring;
+    if (y == 0)
+        ring = z;
+    else if (y == n - 1)
+        ring = n + z;
+    else
+    {
+        ASSERT(z == 0 || z == n - 1);
+        ring = 2 * n + (y - 1) * 2 + (z != 0);
+    }
+    return (size_t)n * n + (size_t)(x - 1) * m_RingSize + ring;
+}
+
+glm::ivec3 CubeGrid::GetSlotPosition(size_t slot) const
+{
+    const size_t n = m_Size;
+    const size_t face = n * n;
+    const size_t inner = (n - 2) * m_RingSize;
+    if (slot < face)
+        return glm::ivec3(0, slot / n, slot % n);
+    if (slot >= face + inner)
+        return glm::ivec3(n - 1, (slot - face - inner) / n, (slot - face - inner) % n);
+
+    const size_t x = 1 + (slot - face) / m_RingSize;
+    const size_t ring = (slot - face) % m_RingSize;
+    if (ring < n)
+        return glm::ivec3(x, 0, ring);
+    if (ring < 2 * n)
+        return glm::ivec3(x, n - 1, ring - n);
+    return glm::ivec3(x, 1 + (ring - 2 * n) / 2, (ring & 1) ? n - 1 : 0);
+}
+
+CubeGrid::LayerSlots CubeGrid::GetLayerSlots(int axisIndex, int layer) const
+{
+    ASSERT(axisIndex >= 0 && axisIndex < 3 && layer >= 0 && layer < m_Size);
+    const int index = axisIndex * m_Size + layer;
+    return { m_LayerIndex.data() + m_LayerStarts[index], m_LayerIndex.data() + m_LayerStarts[index + 1] };
+}
+
+void CubeGrid::ApplyTurn(const LayerTurn& turn)
+{
+    ASSERT(turn.axisIndex >= 0 && turn.axisIndex < 3 && turn.layer >= 0 && turn.layer < m_Size);
+    const CubeRotations& rotations = GetRotations();
+    const int index = turn.axisIndex * m_Size + turn.layer;
+
+    // Split into whole quarter turns (rounded down) and the 0 or 1 eighth turn left over
+    unsigned char& offset = m_LayerOffsets[index];
+    const int total = offset + turn.eighthTurns;
+    const int quarters = total >= 0 ? total / 2 : -((1 - total) / 2);
+    m_OffsetLayers[turn.axisIndex] -= offset;
+    offset = (unsigned char)(total - quarters * 2);
+    m_OffsetLayers[turn.axisIndex] += offset;
+
+    const int count = (quarters % 4 + 4) % 4;
+    if (count == 0)
+        return;
+    unsigned char rotation = 0;
+    for (int i = 0; i < count; i++)
+        rotation = rotations.compose[rotations.quarterTurns[turn.axisIndex]][rotation];
+    const unsigned char* compose = rotations.compose[rotation];
+
+    // Every cubie moves count steps along its cycle and turns with the layer
+    const unsigned int* cycles = m_LayerIndex.data() + m_LayerStarts[index];
+    const unsigned int* fixed = m_LayerIndex.data() + m_LayerFixed[index];
+    const unsigned int* last = m_LayerIndex.data() + m_LayerStarts[index + 1];
+    for (const unsigned int* cycle = cycles; cycle < fixed; cycle += 4)
+    {
+        const unsigned char orientations[4] = {
+            m_Orientations[cycle[0]], m_Orientations[cycle[1]], m_Orientations[cycle[2]], m_Orientations[cycle[3]]
+        };
+        for (int i = 0; i < 4; i++)
+            m_Orientations[cycle[(i + count) & 3]] = compose[orientations[i]];
+    }
+    for (const unsigned int* slot = fixed; slot < last; slot++)
+        m_Orientations[*slot] = compose[m_Orientations[*slot]];
+}
+
+bool CubeGrid::IsAxisBlocked(int axisIndex) const
+{
+    return m_OffsetLayers[(axisIndex + 1) % 3] != 0 || m_OffsetLayers[(axisIndex + 2) % 3] != 0;
+}
+
+bool CubeGrid::IsSolved() const
+{
+    // Identical cubies all turned back to the identity show every face in one color
+    for (unsigned char orientation : m_Orientations)
+    {
+        if (orientation != 0)
+            return false;
+    }
+    for (unsigned char offset : m_LayerOffsets)
+    {
+        if (offset)
+            return false;
+    }
+    return true;
+}
+
+bool CubeGrid::GetFacelets(std::string& facelets) const
+{
+    if (m_OffsetLayers[0] || m_OffsetLayers[1] || m_OffsetLayers[2])
+        return false;
+
+    const CubeRotations& rotations = GetRotations();
+    const int n = m_Size;
+    glm::ivec3 normals[CubeState::FACE_COUNT], rights[CubeState::FACE_COUNT], downs[CubeState::FACE_COUNT];
+    for (int face = 0; face < CubeState::FACE_COUNT; face++)
+        CubeState::GetFaceletFrame(face, normals[face], rights[face], downs[face]);
+
+    facelets.clear();
+    facelets.reserve(CubeState::FACE_COUNT * n * n);
+    for (int face = 0; face < CubeState::FACE_COUNT; face++)
+    {
+        for (int row = 0; row < n; row++)
+        {
+            for (int column = 0; column < n; column++)
+            {
+                // Doubled centered coordinates, as in ApplyTurn
+                const glm::ivec3 centered = normals[face] * (n - 1) + rights[face] * (2 * column - n + 1) + downs[face] * (2 * row - n + 1);
+                const glm::ivec3 position = (centered + glm::ivec3(n - 1)) / 2;
+                const int (&matrix)[3][3] = rotations.matrices[m_Orientations[GetSlotIndex(position.x, position.y, position.z)]];
+
+                // The cubie's rotation maps its home onto the slot, so its transpose takes the sticker's normal home
+                glm::ivec3 home;
+                for (int axis = 0; axis < 3; axis++)
+                    home[axis] = matrix[0][axis] * normals[face].x + matrix[1][axis] * normals[face].y + matrix[2][axis] * normals[face].z;
+                int homeFace = 0;
+                while (normals[homeFace] != home)
+                    homeFace++;
+                facelets.push_back("URFDLB"[homeFace]);
+            }
+        }
+    }
+    return true;
+}
+
+glm::mat4 CubeGrid::GetCubieMatrix(size_t slot) const
+{
+    const CubeRotations& rotations = GetRotations();
+    const glm::ivec3 position = GetSlotPosition(slot);
+    glm::mat4 model(rotations.floatMatrices[m_Orientations[slot]]);
+    model[3] = glm::vec4(glm::vec3(position) - (m_Size - 1) * 0.5f, 1.0f);
+
+    // Layers resting at 45 degrees, which can only be on one axis at a time
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (m_OffsetLayers[axis] && m_LayerOffsets[axis * m_Size + position[axis]])
+        {
+            glm::vec3 axisVector(0.0f);
+            axisVector[axis] = 1.0f;
+            return glm::rotate(glm::mat4(1.0f), glm::radians(45.0f), axisVector) * model;
+        }
+    }
+    return model;
+}
+
+void CubeGrid::GetCubieMatrices(std::vector<glm::mat4>& matrices) const
+{
+    matrices.resize(m_Orientations.size());
+    for (size_t slot = 0; slot < m_Orientations.size(); slot++)
+        matrices[slot] = GetCubieMatrix(slot);
+}
+
+void CubeGrid::UpdateCubieMatrices(std::vector<glm::mat4>& matrices, int axisIndex, int layer) const
+{
+    ASSERT(matrices.size() == m_Orientations.size());
+    for (unsigned int slot : GetLayerSlots(axisIndex, layer))
+        matrices[slot] = GetCubieMatrix(slot);
+}
+
+bool CubeGrid::ParseMoves(const std::string& text, int size, std::vector<LayerTurn>& turns)
+{
+    // Per letter: axis, whether it sits on the positive side, and for M/E/S the face it follows
+    static const std::string s_Letters = "URFDLBMES";
+    static const int s_Axes[] = { 1, 0, 2, 1, 0, 2, 0, 1, 2 };
+    static const bool s_Positive[] = { true, true, true, false, false, false, false, false, true };
+
+    std::istringstream stream(text);
+    std::string token;
+    while (stream >> token)
+    {
+        // Optional layer depth counted from the face, 1 being the face itself
+        size_t cursor = 0;
+        int depth = 1;
+        bool hasDepth = false;
+        if (std::isdigit((unsigned char)token[0]))
+        {
+            depth = 0;
+            while (cursor < token.size() && std::isdigit((unsigned char)token[cursor]))
+                depth = depth * 10 + (token[cursor++] - '0');
+            hasDepth = true;
+        }
+        if (cursor >= token.size())
+            return false;
+        const size_t letter = s_Letters.find(token[cursor++]);
+        if (letter == std::string::npos)
+            return false;
+
+        int clockwise = 1;
+        if (cursor < token.size())
+        {
+            if (token[cursor] == '2')
+                clockwise = 2;
+            else if (token[cursor] == '\'')
+                clockwise = -1;
+            else
+                return false;
+            cursor++;
+        }
+        if (cursor != token.size())
+            return false;
+
+        const bool slice = letter >= 6;
+        if (slice && (hasDepth || size % 2 == 0))
+            return false;
+        if (depth < 1 || depth > size)
+            return false;
+
+        LayerTurn turn;
+        turn.axisIndex = s_Axes[letter];
+        const bool positive = s_Positive[letter];
+        if (slice)
+            turn.layer = size / 2;
+        else
+            turn.layer = positive ? size - depth : depth - 1;
+        // Clockwise seen from a face on the positive side is a negative turn about the axis
+        turn.eighthTurns = (positive ? -clockwise : clockwise) * 2;
+        turns.push_back(turn);
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// One layer turn: the cubies whose coordinate on axisIndex equals layer (0 to size - 1),
+// turned eighthTurns * 45 degrees counter-clockwise about the positive axis
+struct LayerTurn
+{
+    int axisIndex;
+    int layer;
+    int eighthTurns;
+};
+
+// Visible state of an N x N x N cube, for any N from 2 up.
+// Every cubie is drawn from the same mesh, so the cube is fully described by the
+// rotation of the cubie sitting in each slot: one byte (an index into the 24 cube
+// rotations) per slot. Only the 6N^2 - 12N + 8 surface slots are stored, indexed
+// arithmetically, so the hidden interior costs neither memory nor time.
+//
+// Slots are numbered x layer by x layer: the whole x = 0 face, then the ring of
+// surface slots of every inner x layer, then the whole x = N - 1 face.
+//
+// Slots are positions, so which slots make up a layer never changes. A layer
+// index built once lists every (axis, layer) pair's slots as the 4-cycles a
+// quarter turn moves them along, so turning or selecting a layer costs the
+// size of the layer, not of the cube.
+class CubeGrid
+{
+    public:
+        // Slots of one layer, straight out of the index
+        struct LayerSlots
+        {
+            const unsigned int* first;
+            const unsigned int* last;
+
+            inline const unsigned int* begin() const { return first; }
+            inline const unsigned int* end() const { return last; }
+            inline size_t size() const { return last - first; }
+        };
+    private:
+        int m_Size;
+        int m_RingSize;
+        std::vector<unsigned char> m_Orientations;
+        // 3 * size entries, 1 when a layer rests 45 degrees past its last quarter turn
+        std::vector<unsigned char> m_LayerOffsets;
+        unsigned int m_OffsetLayers[3];
+
+        // Layer (axis * size + layer) owns m_LayerIndex[m_LayerStarts[layer], m_LayerStarts[layer + 1]):
+        // 4-cycles (a -> b -> c -> d -> a under a positive quarter turn) up to m_LayerFixed[layer],
+        // then the slot on the axis, if any, which a turn leaves in place
+        std::vector<unsigned int> m_LayerIndex;
+        std::vector<unsigned int> m_LayerStarts;
+        std::vector<unsigned int> m_LayerFixed;
+
+        void BuildLayerIndex();
+        glm::mat4 GetCubieMatrix(size_t slot) const;
+    public:
+        // Solved
+        explicit CubeGrid(int size = 3);
+
+        inline int GetSize() const { return m_Size; }
+        inline size_t GetSlotCount() const { return m_Orientations.size(); }
+
+        // x, y and z from 0 to size - 1, on the surface
+        size_t GetSlotIndex(int x, int y, int z) const;
+        glm::ivec3 GetSlotPosition(size_t slot) const;
+        // Surface slots in one layer: the whole face for an outer layer, a ring for an inner one
+        LayerSlots GetLayerSlots(int axisIndex, int layer) const;
+
+        // Whole quarter turns reach the orientations, a leftover eighth turn is kept as a layer offset
+        void ApplyTurn(const LayerTurn& turn);
+
+        // A layer on another axis rests at 45 degrees, so this axis can't move
+        bool IsAxisBlocked(int axisIndex) const;
+        bool IsSolved() const;
+
+        // Stickers of every face in the layout of CubeState::FromFacelets, size x size per face,
+        // each one the letter of the face it started on. False while a layer rests at 45 degrees
+        bool GetFacelets(std::string& facelets) const;
+
+        // Model matrix of every surface cubie in slot order, for unit cubies centered on the origin
+        void GetCubieMatrices(std::vector<glm::mat4>& matrices) const;
+        // Refresh only the matrices of one layer, all a turn of that layer changes
+        void UpdateCubieMatrices(std::vector<glm::mat4>& matrices, int axisIndex, int layer) const;
+
+        // Standard notation separated by spaces. A face letter (U R F D L B) turns the outer layer,
+        // with a number in front it turns that layer counted from the face ("2R" is the layer
+        // next to R). M, E and S turn the middle layer of odd cubes, following L, D and F.
+        // False on a token that doesn't parse or a layer the cube doesn't have
+        static bool ParseMoves(const std::string& text, int size, std::vector<LayerTurn>& turns);
+};
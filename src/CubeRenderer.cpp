@@ -0,0 +1,267 @@
+#include <CubeRenderer.h>
+#include <CubeFaceRotations.h>
+#include <GLState.h>
+#include <Profiler.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+
+/* Cube vertices: 24 vertices (4 per face) to allow distinct colors/textures per face */
+static const float s_CubieVertices[] = {
+    // positions          // colors           // texCoords
+    // Front face (Red)
+    -0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   0.0f, 1.0f,
+    // Back face (Orange)
+    -0.5f, -0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   0.0f, 1.0f,
+    // Top face (White)
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 1.0f,   0.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 1.0f,   1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 1.0f,   1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 1.0f,   0.0f, 1.0f,
+    // Bottom face (Yellow)
+    -0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,   0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,   1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,   1.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,   0.0f, 1.0f,
+    // Right face (Blue)
+     0.5f, -0.5f, -0.5f,  0.0f, 0.0f, 1.0f,   0.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f, 0.0f, 1.0f,   1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,   1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,   0.0f, 1.0f,
+    // Left face (Green)
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 0.0f,   0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,   1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f, 0.0f,   1.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 1.0f, 0.0f,   0.0f, 1.0f
+};
+
+/* Indices for vertices order */
+static const unsigned int s_CubieIndices[] = {
+    0, 1, 2, 2, 3, 0,       // Front
+    4, 5, 6, 6, 7, 4,       // Back
+    8, 9, 10, 10, 11, 8,    // Top
+    12, 13, 14, 14, 15, 12, // Bottom
+    16, 17, 18, 18, 19, 16, // Right
+    20, 21, 22, 22, 23, 20  // Left
+};
+
+/* World Axes vertices (X=Magenta, Y=Cyan, Z=White) */
+static const float s_AxisVertices[] = {
+    // positions          // colors           // texCoords
+     0.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f,   0.5f, 0.5f, // X-axis (Magenta)
+    10.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f,   0.5f, 0.5f,
+     0.0f,  0.0f,  0.0f,  0.0f, 1.0f, 1.0f,   0.5f, 0.5f, // Y-axis (Cyan)
+     0.0f, 10.0f,  0.0f,  0.0f, 1.0f, 1.0f,   0.5f, 0.5f,
+     0.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f,   0.5f, 0.5f, // Z-axis (White)
+     0.0f,  0.0f, 10.0f,  1.0f, 1.0f, 1.0f,   0.5f, 0.5f
+};
+
+CubeRenderer::CubeRenderer(unsigned int maxInstances, bool instanced, BufferUsage instanceUsage)
+    : m_CubieVB(s_CubieVertices, sizeof(s_CubieVertices)),
+      m_CubieIB(s_CubieIndices, sizeof(s_CubieIndices)),
+      m_InstanceVB(nullptr, maxInstances * sizeof(glm::mat4), instanceUsage),
+      m_AxisVB(s_AxisVertices, sizeof(s_AxisVertices)),
+      m_Texture("res/textures/plane.png"),
+      m_Shader("res/shaders/basic.shader"),
+      m_InstancedShader("res/shaders/instanced.shader"),
+      m_MaxInstances(maxInstances),
+      m_Instanced(instanced)
+{
+    /* Blend to fix images with transperancy */
+    GLCall(glEnable(GL_BLEND));
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(3);  // positions
+    layout.Push<float>(3);  // colors
+    layout.Push<float>(2);  // texCoords
+    m_CubieVA.AddBuffer(m_CubieVB, layout);
+
+    /* Per-instance model matrices, one mat4 per cubie (locations 3-6) */
+    VertexBufferLayout instanceLayout;
+    instanceLayout.Push<glm::mat4>(1, 1);
+    m_CubieVA.AddBuffer(m_InstanceVB, instanceLayout);
+
+    // Reuse the same layout as the cube
+    m_AxisVA.AddBuffer(m_AxisVB, layout);
+
+    /* Resolve the uniforms used every frame once, up front */
+    m_Color = m_Shader.GetUniformHandle<glm::vec4>("u_Color");
+    m_TextureSlot = m_Shader.GetUniformHandle<int>("u_Texture");
+    m_Model = m_Shader.GetUniformHandle<glm::mat4>("u_Model");
+    m_InstancedColor = m_InstancedShader.GetUniformHandle<glm::vec4>("u_Color");
+    m_InstancedTextureSlot = m_InstancedShader.GetUniformHandle<int>("u_Texture");
+    m_BatchPlacementsUniform = m_InstancedShader.GetUniformHandle<glm::mat4>("u_BatchPlacements");
+    m_BatchEndsUniform = m_InstancedShader.GetUniformHandle<int>("u_BatchEnds");
+
+    /* Unbind all to prevent accidentally modifying them */
+    m_CubieVA.Unbind();
+    m_CubieVB.Unbind();
+    m_CubieIB.Unbind();
+
+    /* Enables the Depth Buffer */
+    GLCall(glEnable(GL_DEPTH_TEST));
+}
+
+void CubeRenderer::Draw(const CubeSnapshot& snapshot, float alpha, const std::vector<glm::mat4>& placements)
+{
+    m_Commands.Reset(0);
+    Record(m_Commands, snapshot, alpha, placements);
+    for (const RenderCommand& command : m_Commands.GetCommands())
+        Execute(m_Commands, command);
+}
+
+void CubeRenderer::Record(RenderCommandBuffer& commands, const CubeSnapshot& snapshot, float alpha, const std::vector<glm::mat4>& placements)
+{
+    PROFILE_SCOPE("RecordCubies");
+    commands.DrawAxes();
+
+    /* Each turning layer is one batch under a single partial rotation, every other cubie is the resting batch */
+    const std::vector<glm::mat4>& cubieMatrices = snapshot.cubieMatrices;
+    const std::vector<TurningLayer>& layers = snapshot.layers;
+    const int batchCount = 1 + (int)layers.size();
+    ASSERT(layers.size() <= MAX_TURNING_LAYERS);
+    ASSERT(cubieMatrices.size() <= m_MaxInstances);
+    m_Moving.resize(cubieMatrices.size(), 0);
+    m_BatchRotations[0] = glm::mat4(1.0f);
+    for (int batch = 1; batch < batchCount; batch++)
+    {
+        const TurningLayer& layer = layers[batch - 1];
+        m_BatchRotations[batch] = glm::rotate(glm::mat4(1.0f), snapshot.GetAngle(layer, alpha), snapshot.axis);
+        for (unsigned int slot : layer.slots)
+            m_Moving[slot] = (unsigned char)batch;
+    }
+
+    /* Resting cubies first, then every turning layer, so each batch is a contiguous range of instances */
+    int* batchEnds = nullptr;
+    glm::mat4* matrices = commands.DrawCubies((unsigned int)cubieMatrices.size(), batchCount, (unsigned int)placements.size(), batchEnds);
+    unsigned int instance = 0;
+    for (size_t i = 0; i < cubieMatrices.size(); i++)
+    {
+        if (!m_Moving[i])
+            matrices[instance++] = cubieMatrices[i];
+    }
+    batchEnds[0] = instance;
+    for (int batch = 1; batch < batchCount; batch++)
+    {
+        for (unsigned int slot : layers[batch - 1].slots)
+            matrices[instance++] = cubieMatrices[slot];
+        batchEnds[batch] = instance;
+    }
+
+    /* Then each placement's matrix for every batch */
+    for (const glm::mat4& placement : placements)
+    {
+        for (int batch = 0; batch < batchCount; batch++)
+            matrices[instance++] = placement * m_BatchRotations[batch];
+    }
+
+    /* Clear only the marks set above, so the marks never cost a full pass */
+    for (const TurningLayer& layer : layers)
+        for (unsigned int slot : layer.slots)
+            m_Moving[slot] = 0;
+}
+
+void CubeRenderer::Execute(const RenderCommandBuffer& commands, const RenderCommand& command)
+{
+    m_Texture.Bind();
+    if (command.type == RenderCommandType::DrawAxes)
+        DrawAxes();
+    else if (command.type == RenderCommandType::DrawCubies)
+        DrawCubies(commands, command);
+}
+
+void CubeRenderer::DrawAxes()
+{
+    PROFILE_SCOPE("Axes");
+    GPU_PROFILE_SCOPE("Axes");
+
+    /* Initialize uniform color */
+    glm::vec4 color = glm::vec4(1.0);
+    m_Shader.Bind();
+    m_Shader.SetUniform(m_Color, color);
+    m_Shader.SetUniform(m_TextureSlot, 0);
+
+    /* Disable depth test so axes are drawn on top of everything */
+    GLCall(glDisable(GL_DEPTH_TEST));
+
+    /* Draw World Axes (Fixed in space) */
+    m_Shader.SetUniform(m_Model, glm::mat4(1.0f));
+    m_AxisVA.Bind();
+    GLCall(glLineWidth(2.0f));
+    GLCall(glDrawArrays(GL_LINES, 0, 6));
+    GLState::CountDraw();
+
+    /* Draw Local Axes (Rotating with the cube) */
+    GLCall(glLineWidth(5.0f));
+    GLCall(glDrawArrays(GL_LINES, 0, 6));
+    GLState::CountDraw();
+    GLCall(glLineWidth(1.0f)); // Reset line width
+
+    /* Re-enable depth test for the cube */
+    GLCall(glEnable(GL_DEPTH_TEST));
+}
+
+void CubeRenderer::DrawCubies(const RenderCommandBuffer& commands, const RenderCommand& command)
+{
+    PROFILE_SCOPE("Cubies");
+    GPU_PROFILE_SCOPE("Cubies");
+
+    glm::vec4 color = glm::vec4(1.0);
+    m_CubieVA.Bind();
+    m_CubieIB.Bind();
+
+    /* Recorded as the instances batch by batch, then the batches' matrices for each placement */
+    const glm::mat4* instances = commands.GetMatrices(command);
+    const glm::mat4* batchPlacements = instances + command.instanceCount;
+    const int* batchEnds = commands.GetBatchEnds(command);
+    const int batchCount = (int)command.batchCount;
+
+    if (m_Instanced)
+    {
+        /* The instances go to the GPU as recorded */
+        const unsigned int instanceCount = command.instanceCount;
+        ASSERT(instanceCount <= m_MaxInstances);
+        glm::mat4* mapped = static_cast<glm::mat4*>(m_InstanceVB.Map());
+        std::copy(instances, instances + instanceCount, mapped);
+        m_InstanceVB.Unmap(instanceCount * sizeof(glm::mat4));
+
+        /* One call per placement draws every batch, the shader picks the batch's matrix by instance */
+        m_InstancedShader.Bind();
+        m_InstancedShader.SetUniform(m_InstancedColor, color);
+        m_InstancedShader.SetUniform(m_InstancedTextureSlot, 0);
+        m_InstancedShader.SetUniform(m_BatchEndsUniform, batchEnds, batchCount);
+        for (unsigned int placement = 0; placement < command.placementCount; placement++)
+        {
+            m_InstancedShader.SetUniform(m_BatchPlacementsUniform, batchPlacements + placement * batchCount, batchCount);
+            GLCall(glDrawElementsInstanced(GL_TRIANGLES, m_CubieIB.GetCount(), GL_UNSIGNED_INT, m_CubieIB.GetIndicesOffset(), instanceCount));
+            GLState::CountDraw();
+        }
+        m_InstanceVB.EndFrame();
+    }
+    else
+    {
+        m_Shader.Bind();
+        for (unsigned int placement = 0; placement < command.placementCount; placement++)
+        {
+            int instance = 0;
+            for (int batch = 0; batch < batchCount; batch++)
+            {
+                const glm::mat4& batchPlacement = batchPlacements[placement * batchCount + batch];
+                for (; instance < batchEnds[batch]; instance++)
+                {
+                    m_Shader.SetUniform(m_Model, batchPlacement * instances[instance]);
+                    GLCall(glDrawElements(GL_TRIANGLES, m_CubieIB.GetCount(), GL_UNSIGNED_INT, m_CubieIB.GetIndicesOffset()));
+                    GLState::CountDraw();
+                }
+            }
+        }
+    }
+}
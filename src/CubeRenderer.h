@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <Debugger.h>
+#include <VertexBuffer.h>
+#include <VertexBufferLayout.h>
+#include <IndexBuffer.h>
+#include <VertexArray.h>
+#include <CubeFaceRotations.h>
+#include <RenderCommands.h>
+#include <Shader.h>
+#include <Texture.h>
+
+#include <vector>
+
+// Draws the world axes and the cubies: one textured cube mesh drawn at every
+// cubie matrix of a CubeSnapshot (the surface of the cube), with its turning
+// layers applied at their angle part way through the snapshot's step.
+// The view and projection come from the FrameConstants block.
+// Drawing is split in two: Record works out every matrix into a command buffer
+// without touching GL, Execute sends a recorded command to GL; Draw does both.
+class CubeRenderer
+{
+    private:
+        VertexArray m_CubieVA;
+        VertexBuffer m_CubieVB;
+        IndexBuffer m_CubieIB;
+        VertexBuffer m_InstanceVB;
+        VertexArray m_AxisVA;
+        VertexBuffer m_AxisVB;
+        Texture m_Texture;
+        Shader m_Shader;
+        Shader m_InstancedShader;
+
+        UniformHandle<glm::vec4> m_Color;
+        UniformHandle<int> m_TextureSlot;
+        UniformHandle<glm::mat4> m_Model;
+        UniformHandle<glm::vec4> m_InstancedColor;
+        UniformHandle<int> m_InstancedTextureSlot;
+        UniformHandle<glm::mat4> m_BatchPlacementsUniform;
+        UniformHandle<int> m_BatchEndsUniform;
+
+        unsigned int m_MaxInstances;
+        bool m_Instanced;
+
+        // Recording side
+        // Turning layer (from 1) of every slot while a frame is recorded, all zero in between
+        std::vector<unsigned char> m_Moving;
+        // Batch 0 holds the resting cubies, batch i the i-th turning layer
+        glm::mat4 m_BatchRotations[MAX_TURNING_LAYERS + 1];
+        // For Draw, which records and executes in one go
+        RenderCommandBuffer m_Commands;
+
+        void DrawAxes();
+        void DrawCubies(const RenderCommandBuffer& commands, const RenderCommand& command);
+    public:
+        // maxInstances bounds the cubies per Draw in instanced mode (placements reuse the same instances),
+        // instanceUsage picks how the per-frame instance matrices reach the GPU
+        CubeRenderer(unsigned int maxInstances, bool instanced = true, BufferUsage instanceUsage = BufferUsage::Persistent);
+
+        // Record drawing the axes, then the whole cube once per placement matrix, as it was alpha (0 to 1)
+        // of the way through the snapshot's step. Any thread, as long as only one records at a time
+        void Record(RenderCommandBuffer& commands, const CubeSnapshot& snapshot, float alpha, const std::vector<glm::mat4>& placements = { glm::mat4(1.0f) });
+        // Run a DrawAxes or DrawCubies command, on the thread the context is current on
+        void Execute(const RenderCommandBuffer& commands, const RenderCommand& command);
+
+        // Record and execute right away
+        void Draw(const CubeSnapshot& snapshot, float alpha, const std::vector<glm::mat4>& placements = { glm::mat4(1.0f) });
+
+        inline void SetInstanced(bool instanced) { m_Instanced = instanced; }
+};
@@ -0,0 +1,420 @@
+#include <CubeState.h>
+#include <Debugger.h>
+
+#include <cstring>
+#include <sstream>
+
+// Outward normal of every face
+static const glm::ivec3 s_FaceNormals[CubeState::FACE_COUNT] = {
+    { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, -1, 0 }, { -1, 0, 0 }, { 0, 0, -1 }
+};
+
+// Facelet layout: the directions in which each face's columns and rows run, seen from outside
+static const glm::ivec3 s_FaceRight[CubeState::FACE_COUNT] = {
+    { 1, 0, 0 }, { 0, 0, -1 }, { 1, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { -1, 0, 0 }
+};
+static const glm::ivec3 s_FaceDown[CubeState::FACE_COUNT] = {
+    { 0, 0, 1 }, { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 }
+};
+
+// Faces each slot touches: the U/D face first (F/B for the middle layer edges),
+// then clockwise seen from outside. A piece's twist is the position of its own
+// first facelet in the list of the slot it sits in.
+static const int s_CornerFaces[CubeState::CORNER_COUNT][3] = {
+    { CubeState::U, CubeState::R, CubeState::F }, { CubeState::U, CubeState::F, CubeState::L },
+    { CubeState::U, CubeState::L, CubeState::B }, { CubeState::U, CubeState::B, CubeState::R },
+    { CubeState::D, CubeState::F, CubeState::R }, { CubeState::D, CubeState::L, CubeState::F },
+    { CubeState::D, CubeState::B, CubeState::L }, { CubeState::D, CubeState::R, CubeState::B }
+};
+static const int s_EdgeFaces[CubeState::EDGE_COUNT][2] = {
+    { CubeState::U, CubeState::R }, { CubeState::U, CubeState::F }, { CubeState::U, CubeState::L }, { CubeState::U, CubeState::B },
+    { CubeState::D, CubeState::R }, { CubeState::D, CubeState::F }, { CubeState::D, CubeState::L }, { CubeState::D, CubeState::B },
+    { CubeState::F, CubeState::R }, { CubeState::F, CubeState::L }, { CubeState::B, CubeState::L }, { CubeState::B, CubeState::R }
+};
+
+static inline int AxisOfFace(int face)
+{
+    static const int axes[3] = { 1, 0, 2 };
+    return axes[face % 3];
+}
+
+// glm::dot only takes floating point vectors
+static inline int Dot(glm::ivec3 a, glm::ivec3 b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Index of the sticker on a face of the piece at position (coordinates -1 to 1)
+static inline int FaceletAt(int face, glm::ivec3 position)
+{
+    return face * 9 + (Dot(position, s_FaceDown[face]) + 1) * 3 + Dot(position, s_FaceRight[face]) + 1;
+}
+
+// 90 degrees counter-clockwise about the positive axis
+static glm::ivec3 QuarterTurn(glm::ivec3 v, int axisIndex)
+{
+    switch (axisIndex)
+    {
+    case 0:
+        return glm::ivec3(v.x, -v.z, v.y);
+    case 1:
+        return glm::ivec3(v.z, v.y, -v.x);
+    default:
+        return glm::ivec3(-v.y, v.x, v.z);
+    }
+}
+
+static int FindFacelet(const int* faces, int count, glm::ivec3 normal)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (s_FaceNormals[faces[i]] == normal)
+            return i;
+    }
+    ASSERT(false);
+    return 0;
+}
+
+// A move as a cubie cube: slot i receives the piece from slot cp[i], twisted by co[i]
+struct MoveTable
+{
+    unsigned char cp[CubeState::CORNER_COUNT];
+    unsigned char co[CubeState::CORNER_COUNT];
+    unsigned char ep[CubeState::EDGE_COUNT];
+    unsigned char eo[CubeState::EDGE_COUNT];
+};
+
+struct CubeTables
+{
+    MoveTable moves[CubeState::MOVE_COUNT];
+    glm::ivec3 cornerPositions[CubeState::CORNER_COUNT];
+    glm::ivec3 edgePositions[CubeState::EDGE_COUNT];
+
+    CubeTables()
+    {
+        for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+            cornerPositions[i] = s_FaceNormals[s_CornerFaces[i][0]] + s_FaceNormals[s_CornerFaces[i][1]] + s_FaceNormals[s_CornerFaces[i][2]];
+        for (int i = 0; i < CubeState::EDGE_COUNT; i++)
+            edgePositions[i] = s_FaceNormals[s_EdgeFaces[i][0]] + s_FaceNormals[s_EdgeFaces[i][1]];
+
+        // Turn every face's layer geometrically, then derive the double and inverse turns
+        for (int face = 0; face < CubeState::FACE_COUNT; face++)
+        {
+            MoveTable& quarter = moves[face * 3];
+            BuildQuarterTurn(face, quarter);
+            Multiply(quarter, quarter, moves[face * 3 + 1]);
+            Multiply(moves[face * 3 + 1], quarter, moves[face * 3 + 2]);
+        }
+    }
+
+    int FindCorner(glm::ivec3 position) const
+    {
+        for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+        {
+            if (cornerPositions[i] == position)
+                return i;
+        }
+        ASSERT(false);
+        return 0;
+    }
+
+    int FindEdge(glm::ivec3 position) const
+    {
+        for (int i = 0; i < CubeState::EDGE_COUNT; i++)
+        {
+            if (edgePositions[i] == position)
+                return i;
+        }
+        ASSERT(false);
+        return 0;
+    }
+
+    void BuildQuarterTurn(int face, MoveTable& move) const
+    {
+        const glm::ivec3 normal = s_FaceNormals[face];
+        const int axisIndex = AxisOfFace(face);
+        // Clockwise seen from the face is three positive quarter turns on a positive face, one on a negative face
+        const int turns = face < 3 ? 3 : 1;
+        auto turn = [&](glm::ivec3 v) {
+            for (int i = 0; i < turns; i++)
+                v = QuarterTurn(v, axisIndex);
+            return v;
+        };
+
+        for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+        {
+            move.cp[i] = (unsigned char)i;
+            move.co[i] = 0;
+        }
+        for (int i = 0; i < CubeState::EDGE_COUNT; i++)
+        {
+            move.ep[i] = (unsigned char)i;
+            move.eo[i] = 0;
+        }
+        for (int from = 0; from < CubeState::CORNER_COUNT; from++)
+        {
+            if (Dot(cornerPositions[from], normal) != 1)
+                continue;
+            const int to = FindCorner(turn(cornerPositions[from]));
+            move.cp[to] = (unsigned char)from;
+            move.co[to] = (unsigned char)FindFacelet(s_CornerFaces[to], 3, turn(s_FaceNormals[s_CornerFaces[from][0]]));
+        }
+        for (int from = 0; from < CubeState::EDGE_COUNT; from++)
+        {
+            if (Dot(edgePositions[from], normal) != 1)
+                continue;
+            const int to = FindEdge(turn(edgePositions[from]));
+            move.ep[to] = (unsigned char)from;
+            move.eo[to] = (unsigned char)FindFacelet(s_EdgeFaces[to], 2, turn(s_FaceNormals[s_EdgeFaces[from][0]]));
+        }
+    }
+
+    // result = a followed by b
+    static void Multiply(const MoveTable& a, const MoveTable& b, MoveTable& result)
+    {
+        for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+        {
+            result.cp[i] = a.cp[b.cp[i]];
+            result.co[i] = (unsigned char)((a.co[b.cp[i]] + b.co[i]) % 3);
+        }
+        for (int i = 0; i < CubeState::EDGE_COUNT; i++)
+        {
+            result.ep[i] = a.ep[b.ep[i]];
+            result.eo[i] = (unsigned char)(a.eo[b.ep[i]] ^ b.eo[i]);
+        }
+    }
+};
+
+static const CubeTables& GetTables()
+{
+    static const CubeTables tables;
+    return tables;
+}
+
+CubeState::CubeState()
+{
+    for (int i = 0; i < CORNER_COUNT; i++)
+    {
+        cp[i] = (unsigned char)i;
+        co[i] = 0;
+    }
+    for (int i = 0; i < EDGE_COUNT; i++)
+    {
+        ep[i] = (unsigned char)i;
+        eo[i] = 0;
+    }
+}
+
+void CubeState::ApplyMove(int move)
+{
+    ASSERT(move >= 0 && move < MOVE_COUNT);
+    static const unsigned char s_AddTwist[3][3] = { { 0, 1, 2 }, { 1, 2, 0 }, { 2, 0, 1 } };
+    const MoveTable& table = GetTables().moves[move];
+
+    unsigned char corners[CORNER_COUNT], cornerTwists[CORNER_COUNT];
+    for (int i = 0; i < CORNER_COUNT; i++)
+    {
+        corners[i] = cp[table.cp[i]];
+        cornerTwists[i] = s_AddTwist[co[table.cp[i]]][table.co[i]];
+    }
+    unsigned char edges[EDGE_COUNT], edgeFlips[EDGE_COUNT];
+    for (int i = 0; i < EDGE_COUNT; i++)
+    {
+        edges[i] = ep[table.ep[i]];
+        edgeFlips[i] = eo[table.ep[i]] ^ table.eo[i];
+    }
+    std::memcpy(cp, corners, sizeof(cp));
+    std::memcpy(co, cornerTwists, sizeof(co));
+    std::memcpy(ep, edges, sizeof(ep));
+    std::memcpy(eo, edgeFlips, sizeof(eo));
+}
+
+void CubeState::ApplyMoves(const std::vector<int>& moves)
+{
+    for (int move : moves)
+        ApplyMove(move);
+}
+
+bool CubeState::IsSolved() const
+{
+    for (int i = 0; i < CORNER_COUNT; i++)
+    {
+        if (cp[i] != i || co[i] != 0)
+            return false;
+    }
+    for (int i = 0; i < EDGE_COUNT; i++)
+    {
+        if (ep[i] != i || eo[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+CubeState CubeState::GetInverse() const
+{
+    // Piece p in slot i, twisted by t, becomes piece i in slot p, twisted back
+    CubeState inverse;
+    for (int i = 0; i < CORNER_COUNT; i++)
+    {
+        inverse.cp[cp[i]] = (unsigned char)i;
+        inverse.co[cp[i]] = (unsigned char)((3 - co[i]) % 3);
+    }
+    for (int i = 0; i < EDGE_COUNT; i++)
+    {
+        inverse.ep[ep[i]] = (unsigned char)i;
+        inverse.eo[ep[i]] = eo[i];
+    }
+    return inverse;
+}
+
+// Even permutations give 0, odd ones 1
+static int Parity(const unsigned char* permutation, int count)
+{
+    int parity = 0;
+    for (int i = 0; i < count; i++)
+        for (int j = i + 1; j < count; j++)
+            parity ^= permutation[j] < permutation[i];
+    return parity;
+}
+
+bool CubeState::IsValid() const
+{
+    unsigned int corners = 0, edges = 0;
+    int twist = 0, flip = 0;
+    for (int i = 0; i < CORNER_COUNT; i++)
+    {
+        if (cp[i] >= CORNER_COUNT || co[i] > 2)
+            return false;
+        corners |= 1u << cp[i];
+        twist += co[i];
+    }
+    for (int i = 0; i < EDGE_COUNT; i++)
+    {
+        if (ep[i] >= EDGE_COUNT || eo[i] > 1)
+            return false;
+        edges |= 1u << ep[i];
+        flip += eo[i];
+    }
+    return corners == (1u << CORNER_COUNT) - 1 && edges == (1u << EDGE_COUNT) - 1
+        && twist % 3 == 0 && flip % 2 == 0 && Parity(cp, CORNER_COUNT) == Parity(ep, EDGE_COUNT);
+}
+
+bool CubeState::ParseMoves(const std::string& text, std::vector<int>& moves)
+{
+    static const std::string s_Faces = "URFDLB";
+    std::istringstream stream(text);
+    std::string token;
+    while (stream >> token)
+    {
+        const size_t face = s_Faces.find(token[0]);
+        if (face == std::string::npos || token.size() > 2)
+            return false;
+        int power = 1;
+        if (token.size() == 2)
+        {
+            if (token[1] == '2')
+                power = 2;
+            else if (token[1] == '\'')
+                power = 3;
+            else
+                return false;
+        }
+        moves.push_back((int)face * 3 + power - 1);
+    }
+    return true;
+}
+
+std::string CubeState::MoveName(int move)
+{
+    static const char* s_Suffixes[3] = { "", "2", "'" };
+    return std::string(1, "URFDLB"[move / 3]) + s_Suffixes[move % 3];
+}
+
+bool CubeState::FromFacelets(const std::string& facelets, CubeState& state)
+{
+    if (facelets.size() != FACELET_COUNT)
+        return false;
+
+    // Colors to faces, through the centers
+    int faceOfColor[256];
+    for (int& face : faceOfColor)
+        face = -1;
+    for (int face = 0; face < FACE_COUNT; face++)
+    {
+        int& centerFace = faceOfColor[(unsigned char)facelets[face * 9 + 4]];
+        if (centerFace != -1)
+            return false;
+        centerFace = face;
+    }
+    int faces[FACELET_COUNT];
+    for (int i = 0; i < FACELET_COUNT; i++)
+    {
+        faces[i] = faceOfColor[(unsigned char)facelets[i]];
+        if (faces[i] < 0)
+            return false;
+    }
+
+    // A corner's twist is where its U/D sticker is, its identity the faces read clockwise from there
+    const CubeTables& tables = GetTables();
+    for (int slot = 0; slot < CORNER_COUNT; slot++)
+    {
+        int stickers[3], twist = -1;
+        for (int i = 0; i < 3; i++)
+        {
+            stickers[i] = faces[FaceletAt(s_CornerFaces[slot][i], tables.cornerPositions[slot])];
+            if (stickers[i] == U || stickers[i] == D)
+                twist = i;
+        }
+        if (twist < 0)
+            return false;
+        state.co[slot] = (unsigned char)twist;
+        state.cp[slot] = CORNER_COUNT;
+        for (int piece = 0; piece < CORNER_COUNT; piece++)
+        {
+            if (s_CornerFaces[piece][0] == stickers[twist] && s_CornerFaces[piece][1] == stickers[(twist + 1) % 3]
+                && s_CornerFaces[piece][2] == stickers[(twist + 2) % 3])
+                state.cp[slot] = (unsigned char)piece;
+        }
+    }
+    for (int slot = 0; slot < EDGE_COUNT; slot++)
+    {
+        const int first = faces[FaceletAt(s_EdgeFaces[slot][0], tables.edgePositions[slot])];
+        const int second = faces[FaceletAt(s_EdgeFaces[slot][1], tables.edgePositions[slot])];
+        state.ep[slot] = EDGE_COUNT;
+        state.eo[slot] = 0;
+        for (int piece = 0; piece < EDGE_COUNT; piece++)
+        {
+            if (s_EdgeFaces[piece][0] == first && s_EdgeFaces[piece][1] == second)
+            {
+                state.ep[slot] = (unsigned char)piece;
+                state.eo[slot] = 0;
+            }
+            else if (s_EdgeFaces[piece][0] == second && s_EdgeFaces[piece][1] == first)
+            {
+                state.ep[slot] = (unsigned char)piece;
+                state.eo[slot] = 1;
+            }
+        }
+    }
+    return state.IsValid();
+}
+
+void CubeState::GetFaceletFrame(int face, glm::ivec3& normal, glm::ivec3& right, glm::ivec3& down)
+{
+    ASSERT(face >= 0 && face < FACE_COUNT);
+    normal = s_FaceNormals[face];
+    right = s_FaceRight[face];
+    down = s_FaceDown[face];
+}
+
+const int* CubeState::GetCornerFaces(int corner)
+{
+    ASSERT(corner >= 0 && corner < CORNER_COUNT);
+    return s_CornerFaces[corner];
+}
+
+const int* CubeState::GetEdgeFaces(int edge)
+{
+    ASSERT(edge >= 0 && edge < EDGE_COUNT);
+    return s_EdgeFaces[edge];
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// Logical 3x3x3 cube: which piece sits in every corner and edge slot and how it
+// is twisted, in Kociemba's cubie representation. Face moves are table lookups
+// on a few bytes. This is the representation the solvers work on; what is drawn
+// lives in CubeGrid, which handles any size.
+//
+// Local cube axes: U = +Y, R = +X, F = +Z.
+// Moves are numbered face * 3 + (quarter turns - 1) in the face order below,
+// each face turning clockwise as seen from that face: U, U2, U', R, R2, R', ...
+struct CubeState
+{
+    enum Face { U, R, F, D, L, B, FACE_COUNT };
+    enum Corner { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB, CORNER_COUNT };
+    enum Edge { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR, EDGE_COUNT };
+    static const int MOVE_COUNT = 18;
+    static const int FACELET_COUNT = 54;
+
+    // Piece in each slot and its twist: corners 0-2 clockwise, edges 0-1
+    unsigned char cp[CORNER_COUNT];
+    unsigned char co[CORNER_COUNT];
+    unsigned char ep[EDGE_COUNT];
+    unsigned char eo[EDGE_COUNT];
+
+    // Solved
+    CubeState();
+
+    void ApplyMove(int move);
+    void ApplyMoves(const std::vector<int>& moves);
+    bool IsSolved() const;
+    // Every piece present once, twists and flips summing to zero, matching corner and edge parity:
+    // the states a real cube can reach
+    bool IsValid() const;
+    // The state that undoes this one, as the reversed move sequence turns the solved cube into
+    CubeState GetInverse() const;
+
+    // Standard notation separated by spaces ("R U R' U2"), false on an unknown token
+    static bool ParseMoves(const std::string& text, std::vector<int>& moves);
+    static std::string MoveName(int move);
+
+    // Facelet strings give the color of all 54 stickers, face by face in U R F D L B order.
+    // Each face is read row by row as seen from outside it, top row first: U with B at the
+    // top, D with F at the top, the side faces with U at the top. Any 6 characters work as
+    // colors, each one names the face whose center shows it. This is the layout Kociemba's
+    // own solver reads.
+    // False when the stickers don't make up a valid cube
+    static bool FromFacelets(const std::string& facelets, CubeState& state);
+    // Where a face sits in that layout: its outward normal, and the directions its columns and rows run in
+    static void GetFaceletFrame(int face, glm::ivec3& normal, glm::ivec3& right, glm::ivec3& down);
+    // Faces a slot touches: the U/D face first (F/B for the middle layer edges), then clockwise seen from
+    // outside. A twist or flip is the position of the piece's own first face in its slot's list
+    static const int* GetCornerFaces(int corner);
+    static const int* GetEdgeFaces(int edge);
+};
@@ -0,0 +1,544 @@
+#include <CubeSymmetry.h>
+#include <Debugger.h>
+
+#include <bitset>
+#include <cstdlib>
+
+static glm::ivec3 FaceNormal(int face)
+{
+    glm::ivec3 normal, right, down;
+    CubeState::GetFaceletFrame(face, normal, right, down);
+    return normal;
+}
+
+static int FindFace(glm::ivec3 normal)
+{
+    for (int face = 0; face < CubeState::FACE_COUNT; face++)
+    {
+        if (FaceNormal(face) == normal)
+            return face;
+    }
+    ASSERT(false);
+    return 0;
+}
+
+// Position of the slot touching these faces: the sum of their normals
+static glm::ivec3 SlotPosition(const int* faces, int count)
+{
+    glm::ivec3 position(0);
+    for (int i = 0; i < count; i++)
+        position += FaceNormal(faces[i]);
+    return position;
+}
+
+static int FindFacelet(const int* faces, int count, int face)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (faces[i] == face)
+            return i;
+    }
+    ASSERT(false);
+    return 0;
+}
+
+// Where one symmetry takes every slot, and every facelet of it, of one kind of piece
+template <int SLOTS, int FACELETS>
+struct PieceMapping
+{
+    unsigned char to[SLOTS];
+    unsigned char faceletTo[SLOTS][FACELETS]; // Facelet of slot i to its facelet in slot to[i]
+    unsigned char firstFrom[SLOTS];           // Facelet of the piece mapped onto slot i's piece that lands on its first one
+
+    template <typename Map>
+    void Build(const Map& map, const int* (*getFaces)(int))
+    {
+        for (int from = 0; from < SLOTS; from++)
+        {
+            const int* faces = getFaces(from);
+            const glm::ivec3 position = map(SlotPosition(faces, FACELETS));
+            for (int slot = 0; slot < SLOTS; slot++)
+            {
+                if (SlotPosition(getFaces(slot), FACELETS) == position)
+                    to[from] = (unsigned char)slot;
+            }
+            for (int facelet = 0; facelet < FACELETS; facelet++)
+            {
+                faceletTo[from][facelet] = (unsigned char)FindFacelet(getFaces(to[from]), FACELETS, FindFace(map(FaceNormal(faces[facelet]))));
+                if (faceletTo[from][facelet] == 0)
+                    firstFrom[to[from]] = (unsigned char)facelet;
+            }
+        }
+    }
+
+    // A piece twisted by orientation in slot i keeps its facelets in their cyclic order (a reflection reverses
+    // both its order and the slot's), so following its facelet that ends up first is all it takes
+    template <int MODULO>
+    inline void Apply(const unsigned char* pieces, const unsigned char* orientations,
+                      unsigned char* newPieces, unsigned char* newOrientations) const
+    {
+        for (int i = 0; i < SLOTS; i++)
+        {
+            const int piece = to[pieces[i]];
+            newPieces[to[i]] = (unsigned char)piece;
+            newOrientations[to[i]] = faceletTo[i][(orientations[i] + firstFrom[piece]) % MODULO];
+        }
+    }
+};
+
+struct SymmetryTables
+{
+    glm::ivec3 axes[CubeSymmetry::COUNT][3]; // Images of the x, y and z axes
+    bool mirror[CubeSymmetry::COUNT];
+    int inverse[CubeSymmetry::COUNT];
+    int axisRotation[CubeSymmetry::AXIS_COUNT];
+    PieceMapping<CubeState::CORNER_COUNT, 3> corners[CubeSymmetry::COUNT];
+    PieceMapping<CubeState::EDGE_COUNT, 2> edges[CubeSymmetry::COUNT];
+    int moves[CubeSymmetry::COUNT][CubeState::MOVE_COUNT];
+
+    SymmetryTables()
+    {
+        // Every signed permutation of the axes: those keeping the y (U-D) axis first, the identity leading
+        static const int s_Permutations[6][3] = { { 0, 1, 2 }, { 2, 1, 0 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 } };
+        static const int s_PermutationSigns[6] = { 1, -1, -1, -1, 1, 1 };
+        int count = 0;
+        for (int permutation = 0; permutation < 6; permutation++)
+        {
+            for (int signs = 0; signs < 8; signs++)
+            {
+                int determinant = s_PermutationSigns[permutation];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    const int sign = signs & (1 << axis) ? -1 : 1;
+                    glm::ivec3 image(0);
+                    image[s_Permutations[permutation][axis]] = sign;
+                    axes[count][axis] = image;
+                    determinant *= sign;
+                }
+                mirror[count] = determinant < 0;
+                count++;
+            }
+        }
+        ASSERT(count == CubeSymmetry::COUNT);
+
+        for (int symmetry = 0; symmetry < CubeSymmetry::COUNT; symmetry++)
+        {
+            auto map = [&](glm::ivec3 v) { return Map(symmetry, v); };
+            corners[symmetry].Build(map, &CubeState::GetCornerFaces);
+            edges[symmetry].Build(map, &CubeState::GetEdgeFaces);
+        }
+
+        // The inverse maps the axes back
+        for (int symmetry = 0; symmetry < CubeSymmetry::COUNT; symmetry++)
+        {
+            inverse[symmetry] = -1;
+            for (int other = 0; other < CubeSymmetry::COUNT; other++)
+            {
+                if (Map(other, axes[symmetry][0]) == glm::ivec3(1, 0, 0) && Map(other, axes[symmetry][1]) == glm::ivec3(0, 1, 0)
+                    && Map(other, axes[symmetry][2]) == glm::ivec3(0, 0, 1))
+                    inverse[symmetry] = other;
+            }
+            ASSERT(inverse[symmetry] >= 0);
+        }
+
+        // Any rotation taking the x or the z axis onto the y axis will do; the identity for y itself
+        static const glm::ivec3 s_Axes[CubeSymmetry::AXIS_COUNT] = { glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, 1) };
+        for (int axis = 0; axis < CubeSymmetry::AXIS_COUNT; axis++)
+        {
+            axisRotation[axis] = -1;
+            for (int symmetry = 0; symmetry < CubeSymmetry::COUNT && axisRotation[axis] < 0; symmetry++)
+            {
+                if (!mirror[symmetry] && std::abs(Map(symmetry, s_Axes[axis]).y) == 1)
+                    axisRotation[axis] = symmetry;
+            }
+            ASSERT(axisRotation[axis] >= 0);
+        }
+        ASSERT(axisRotation[0] == 0);
+        BuildMoves();
+    }
+
+    inline glm::ivec3 Map(int symmetry, glm::ivec3 v) const
+    {
+        return axes[symmetry][0] * v.x + axes[symmetry][1] * v.y + axes[symmetry][2] * v.z;
+    }
+
+    void Conjugate(const CubeState& state, int symmetry, CubeState& result) const
+    {
+        corners[symmetry].Apply<3>(state.cp, state.co, result.cp, result.co);
+        edges[symmetry].Apply<2>(state.ep, state.eo, result.ep, result.eo);
+    }
+
+    static bool Equal(const CubeState& a, const CubeState& b)
+    {
+        for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+        {
+            if (a.cp[i] != b.cp[i] || a.co[i] != b.co[i])
+                return false;
+        }
+        for (int i = 0; i < CubeState::EDGE_COUNT; i++)
+        {
+            if (a.ep[i] != b.ep[i] || a.eo[i] != b.eo[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Every move seen through a symmetry has to be a move again
+    void BuildMoves()
+    {
+        for (int symmetry = 0; symmetry < CubeSymmetry::COUNT; symmetry++)
+        {
+            for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+            {
+                CubeState turned, conjugate;
+                turned.ApplyMove(move);
+                Conjugate(turned, symmetry, conjugate);
+                moves[symmetry][move] = -1;
+                for (int other = 0; other < CubeState::MOVE_COUNT; other++)
+                {
+                    CubeState candidate;
+                    candidate.ApplyMove(other);
+                    if (Equal(candidate, conjugate))
+                        moves[symmetry][move] = other;
+                }
+                ASSERT(moves[symmetry][move] >= 0);
+            }
+        }
+    }
+};
+
+static const SymmetryTables& GetTables()
+{
+    static const SymmetryTables tables;
+    return tables;
+}
+
+CubeState CubeSymmetry::Conjugate(const CubeState& state, int symmetry)
+{
+    ASSERT(symmetry >= 0 && symmetry < COUNT);
+    CubeState result;
+    GetTables().Conjugate(state, symmetry, result);
+    return result;
+}
+
+int CubeSymmetry::ConjugateMove(int move, int symmetry)
+{
+    ASSERT(symmetry >= 0 && symmetry < COUNT && move >= 0 && move < CubeState::MOVE_COUNT);
+    return GetTables().moves[symmetry][move];
+}
+
+int CubeSymmetry::GetInverse(int symmetry)
+{
+    ASSERT(symmetry >= 0 && symmetry < COUNT);
+    return GetTables().inverse[symmetry];
+}
+
+bool CubeSymmetry::IsMirror(int symmetry)
+{
+    ASSERT(symmetry >= 0 && symmetry < COUNT);
+    return GetTables().mirror[symmetry];
+}
+
+int CubeSymmetry::GetAxisRotation(int axis)
+{
+    ASSERT(axis >= 0 && axis < AXIS_COUNT);
+    return GetTables().axisRotation[axis];
+}
+
+int CornerSymmetry::RankPlacement(const unsigned char* cp)
+{
+    int rank = 0;
+    for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+    {
+        int smaller = 0;
+        for (int j = i + 1; j < CubeState::CORNER_COUNT; j++)
+            smaller += cp[j] < cp[i];
+        rank = rank * (CubeState::CORNER_COUNT - i) + smaller;
+    }
+    return rank;
+}
+
+void CornerSymmetry::UnrankPlacement(int placement, unsigned char* cp)
+{
+    int digits[CubeState::CORNER_COUNT];
+    for (int i = CubeState::CORNER_COUNT - 1; i >= 0; i--)
+    {
+        digits[i] = placement % (CubeState::CORNER_COUNT - i);
+        placement /= CubeState::CORNER_COUNT - i;
+    }
+    // Each digit counts the pieces still unplaced below this slot's
+    unsigned used = 0;
+    for (int i = 0; i < CubeState::CORNER_COUNT; i++)
+    {
+        int piece = 0;
+        for (int freeBelow = digits[i];; piece++)
+        {
+            if (!(used & (1u << piece)) && freeBelow-- == 0)
+                break;
+        }
+        used |= 1u << piece;
+        cp[i] = (unsigned char)piece;
+    }
+}
+
+int CornerSymmetry::RankTwist(const unsigned char* co)
+{
+    int twist = 0;
+    for (int i = 0; i < CubeState::CORNER_COUNT - 1; i++)
+        twist = twist * 3 + co[i];
+    return twist;
+}
+
+void CornerSymmetry::UnrankTwist(int twist, unsigned char* co)
+{
+    int twistSum = 0;
+    for (int i = CubeState::CORNER_COUNT - 2; i >= 0; i--)
+    {
+        co[i] = (unsigned char)(twist % 3);
+        twistSum += co[i];
+        twist /= 3;
+    }
+    co[CubeState::CORNER_COUNT - 1] = (unsigned char)((3 - twistSum % 3) % 3);
+}
+
+CornerSymmetry::CornerSymmetry()
+{
+    const SymmetryTables& tables = GetTables();
+    CubeState state, conjugate;
+
+    // U-D symmetries move twists around with the slots, and a mirror turns them the other way,
+    // whatever piece sits where: the placement can stay solved
+    for (int twist = 0; twist < TWIST_COUNT; twist++)
+    {
+        UnrankTwist(twist, state.co);
+        for (int symmetry = 0; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+        {
+            tables.Conjugate(state, symmetry, conjugate);
+            m_TwistConjugate[twist][symmetry] = (uint16_t)RankTwist(conjugate.co);
+        }
+    }
+
+    // The smallest placement of every class is its representative. Walking placements in order, the first one
+    // not reached from an earlier representative starts a class and reaches all the rest of it
+    for (uint16_t& classOf : m_ClassOf)
+        classOf = 0xFFFF;
+    int classCount = 0;
+    for (int placement = 0; placement < PLACEMENT_COUNT; placement++)
+    {
+        if (m_ClassOf[placement] != 0xFFFF)
+            continue;
+        ASSERT(classCount < CLASS_COUNT);
+        m_Representative[classCount] = (uint16_t)placement;
+        m_Stabilizer[classCount] = 0;
+        UnrankPlacement(placement, state.cp);
+        for (int symmetry = 0; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+        {
+            tables.Conjugate(state, symmetry, conjugate);
+            const int reached = RankPlacement(conjugate.cp);
+            if (reached == placement)
+                m_Stabilizer[classCount] |= (uint16_t)(1 << symmetry);
+            // Back to the representative through the inverse; the identity comes first, so that is the
+            // representative's own symmetry
+            if (m_ClassOf[reached] == 0xFFFF)
+                m_ClassOf[reached] = (uint16_t)(classCount << 4 | tables.inverse[symmetry]);
+        }
+        classCount++;
+    }
+    ASSERT(classCount == CLASS_COUNT);
+}
+
+const CornerSymmetry& CornerSymmetry::Get()
+{
+    static const CornerSymmetry symmetry;
+    return symmetry;
+}
+
+int CornerSymmetry::GetEntry(const CubeState& state) const
+{
+    return GetEntry(RankPlacement(state.cp), RankTwist(state.co));
+}
+
+int CornerSymmetry::GetSymmetricEntries(int entry, int* entries) const
+{
+    const int classIndex = entry / TWIST_COUNT;
+    const int twist = entry % TWIST_COUNT;
+    int count = 0;
+    for (int symmetry = 0; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+    {
+        if (!(m_Stabilizer[classIndex] & (1 << symmetry)))
+            continue;
+        const int symmetric = classIndex * TWIST_COUNT + m_TwistConjugate[twist][symmetry];
+        bool seen = false;
+        for (int i = 0; i < count; i++)
+            seen = seen || entries[i] == symmetric;
+        if (!seen)
+            entries[count++] = symmetric;
+    }
+    return count;
+}
+
+EdgeSymmetry::EdgeSymmetry()
+{
+    const SymmetryTables& tables = GetTables();
+    for (int symmetry = 0; symmetry < CubeSymmetry::COUNT; symmetry++)
+    {
+        const PieceMapping<CubeState::EDGE_COUNT, 2>& edges = tables.edges[symmetry];
+        for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+        {
+            m_To[symmetry][slot] = edges.to[slot];
+            // PieceMapping::Apply with the flip coming out of a two-facelet lookup: it changes when the slot's
+            // facelets swap or when the piece's do, but not when both do
+            for (int piece = 0; piece < CubeState::EDGE_COUNT; piece++)
+                m_FlipChange[symmetry][slot][piece] = (unsigned char)(edges.faceletTo[slot][0] ^ edges.firstFrom[edges.to[piece]]);
+        }
+    }
+
+    for (int axis = 0; axis < AXIS_COUNT; axis++)
+    {
+        int count = 0;
+        for (int piece = 0; piece < CubeState::EDGE_COUNT; piece++)
+        {
+            const int to = m_To[tables.axisRotation[axis]][piece];
+            if (to < PIECE_COUNT)
+            {
+                m_AxisPieces[axis][to] = (unsigned char)piece;
+                count++;
+            }
+        }
+        ASSERT(count == PIECE_COUNT);
+    }
+
+    // The smallest slot mask of every class is its representative, found as for the corner placements
+    for (uint16_t& classOf : m_SlotSetClass)
+        classOf = 0xFFFF;
+    int classCount = 0;
+    for (unsigned mask = 0; mask < 1u << CubeState::EDGE_COUNT; mask++)
+    {
+        if (std::bitset<CubeState::EDGE_COUNT>(mask).count() != PIECE_COUNT || m_SlotSetClass[mask] != 0xFFFF)
+            continue;
+        ASSERT(classCount < SLOT_SET_CLASS_COUNT);
+        m_Representative[classCount] = (uint16_t)mask;
+        m_Stabilizer[classCount] = 0;
+        for (int symmetry = 0; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+        {
+            unsigned reached = 0;
+            for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+            {
+                if (mask & (1u << slot))
+                    reached |= 1u << m_To[symmetry][slot];
+            }
+            if (reached == mask)
+                m_Stabilizer[classCount] |= (uint16_t)(1 << symmetry);
+            if (m_SlotSetClass[reached] == 0xFFFF)
+                m_SlotSetClass[reached] = (uint16_t)(classCount << 4 | tables.inverse[symmetry]);
+        }
+        classCount++;
+    }
+    ASSERT(classCount == SLOT_SET_CLASS_COUNT);
+}
+
+const EdgeSymmetry& EdgeSymmetry::Get()
+{
+    static const EdgeSymmetry symmetry;
+    return symmetry;
+}
+
+int EdgeSymmetry::GetGroupEntry(const unsigned char* slots, const unsigned char* flips) const
+{
+    unsigned mask = 0;
+    for (int piece = 0; piece < PIECE_COUNT; piece++)
+        mask |= 1u << slots[piece];
+    const int classOf = m_SlotSetClass[mask];
+    const int symmetry = classOf & 15;
+
+    // U-D symmetries keep the pieces among themselves, so the state seen through one is a state of them again
+    unsigned char inSlot[CubeState::EDGE_COUNT], seenFlips[PIECE_COUNT];
+    for (int piece = 0; piece < PIECE_COUNT; piece++)
+    {
+        inSlot[m_To[symmetry][slots[piece]]] = m_To[symmetry][piece];
+        seenFlips[m_To[symmetry][piece]] = flips[piece] ^ m_FlipChange[symmetry][slots[piece]][piece];
+    }
+    int flip = 0;
+    for (int piece = 0; piece < PIECE_COUNT; piece++)
+        flip = flip * 2 + seenFlips[piece];
+
+    // The pieces in the representative's slots, in slot order
+    unsigned char arrangement[PIECE_COUNT];
+    const unsigned representative = m_Representative[classOf >> 4];
+    int count = 0;
+    for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+    {
+        if (representative & (1u << slot))
+            arrangement[count++] = inSlot[slot];
+    }
+    return ((classOf >> 4) * ARRANGEMENT_COUNT + CornerSymmetry::RankPlacement(arrangement)) * FLIP_COUNT + flip;
+}
+
+int EdgeSymmetry::GetEntry(const unsigned char* slots, const unsigned char* flips, int axis) const
+{
+    if (axis == 0)
+        return GetGroupEntry(slots, flips);
+    // Bring the axis to U-D first: its layer edges become pieces 0 to 7
+    const int rotation = CubeSymmetry::GetAxisRotation(axis);
+    unsigned char rotatedSlots[PIECE_COUNT], rotatedFlips[PIECE_COUNT];
+    for (int piece = 0; piece < PIECE_COUNT; piece++)
+    {
+        const int from = m_AxisPieces[axis][piece];
+        rotatedSlots[piece] = m_To[rotation][slots[from]];
+        rotatedFlips[piece] = flips[from] ^ m_FlipChange[rotation][slots[from]][from];
+    }
+    return GetGroupEntry(rotatedSlots, rotatedFlips);
+}
+
+void EdgeSymmetry::GetState(int entry, unsigned char* slots, unsigned char* flips) const
+{
+    int flip = entry % FLIP_COUNT;
+    for (int piece = PIECE_COUNT - 1; piece >= 0; piece--)
+    {
+        flips[piece] = (unsigned char)(flip & 1);
+        flip >>= 1;
+    }
+    // The arrangement is a Lehmer code over 8 pieces, the same as a corner placement
+    unsigned char arrangement[PIECE_COUNT];
+    CornerSymmetry::UnrankPlacement(entry / FLIP_COUNT % ARRANGEMENT_COUNT, arrangement);
+    const unsigned representative = m_Representative[entry / FLIP_COUNT / ARRANGEMENT_COUNT];
+    int count = 0;
+    for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+    {
+        if (representative & (1u << slot))
+            slots[arrangement[count++]] = (unsigned char)slot;
+    }
+}
+
+int EdgeSymmetry::GetSymmetricEntries(int entry, int* entries) const
+{
+    const int classIndex = entry / FLIP_COUNT / ARRANGEMENT_COUNT;
+    // Half the classes only map onto themselves through the identity
+    if (m_Stabilizer[classIndex] == 1)
+    {
+        entries[0] = entry;
+        return 1;
+    }
+    unsigned char slots[PIECE_COUNT], flips[PIECE_COUNT];
+    GetState(entry, slots, flips);
+    int count = 0;
+    for (int symmetry = 0; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+    {
+        if (!(m_Stabilizer[classIndex] & (1 << symmetry)))
+            continue;
+        unsigned char symmetricSlots[PIECE_COUNT], symmetricFlips[PIECE_COUNT];
+        for (int piece = 0; piece < PIECE_COUNT; piece++)
+        {
+            symmetricSlots[m_To[symmetry][piece]] = m_To[symmetry][slots[piece]];
+            symmetricFlips[m_To[symmetry][piece]] = flips[piece] ^ m_FlipChange[symmetry][slots[piece]][piece];
+        }
+        // The slots are the representative's again, which it reaches through the identity
+        const int symmetric = GetGroupEntry(symmetricSlots, symmetricFlips);
+        bool seen = false;
+        for (int i = 0; i < count; i++)
+            seen = seen || entries[i] == symmetric;
+        if (!seen)
+            entries[count++] = symmetric;
+    }
+    return count;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <CubeState.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// The 48 symmetries of the cube: the 24 rotations and their mirror images. A
+// symmetry maps a state to the one seen through it (the whole cube rotated or
+// reflected, and its colors renamed to match), which is exactly as far from
+// solved: every move of a solution maps to a move. Conjugate is that mapping on
+// cubie states, built geometrically like CubeState's moves, so mirrored twists
+// need no special arithmetic.
+//
+// The first UD_COUNT symmetries keep the U-D axis where it is (possibly upside
+// down). Symmetry 0 is the identity.
+class CubeSymmetry
+{
+    public:
+        static const int COUNT = 48;
+        static const int UD_COUNT = 16;
+        static const int AXIS_COUNT = 3; // U-D, R-L, F-B
+
+        // state seen through symmetry
+        static CubeState Conjugate(const CubeState& state, int symmetry);
+        // The move (CubeState numbering) that move becomes seen through symmetry
+        static int ConjugateMove(int move, int symmetry);
+        static int GetInverse(int symmetry);
+        static bool IsMirror(int symmetry);
+        // A rotation seen through which the faces around axis (as AXIS_COUNT lists them) are the U and D faces
+        static int GetAxisRotation(int axis);
+};
+
+// Sym-coordinate for the corners (placement and twist), up to the 16 U-D
+// symmetries: the 40320 placements fall into CLASS_COUNT classes, and a state is
+// stored once for its whole class, as the class representative's placement and
+// the twist it takes on when seen through the symmetry leading there. For U-D
+// symmetries the twist of a conjugate depends on the twists alone, so conversion
+// is three table lookups.
+//
+// Entries are class * TWIST_COUNT + twist: 6 million rather than 88 million.
+class CornerSymmetry
+{
+    public:
+        static const int PLACEMENT_COUNT = 40320; // 8!
+        static const int TWIST_COUNT = 2187;      // 3^7
+        static const int CLASS_COUNT = 2768;
+        static const int ENTRY_COUNT = CLASS_COUNT * TWIST_COUNT;
+    private:
+        uint16_t m_ClassOf[PLACEMENT_COUNT];                            // class << 4 | symmetry to the representative
+        uint16_t m_TwistConjugate[TWIST_COUNT][CubeSymmetry::UD_COUNT];
+        uint16_t m_Representative[CLASS_COUNT];                          // Placement
+        uint16_t m_Stabilizer[CLASS_COUNT];                              // Bit set for every symmetry that maps it onto itself
+
+        CornerSymmetry();
+    public:
+        CornerSymmetry(const CornerSymmetry&) = delete;
+        CornerSymmetry& operator=(const CornerSymmetry&) = delete;
+        // Built on first use, a few milliseconds
+        static const CornerSymmetry& Get();
+
+        // placement is the Lehmer code of the piece in every slot (cp), twist the twists of slots 0 to 6 in base 3 (co)
+        inline int GetEntry(int placement, int twist) const
+        {
+            const int classOf = m_ClassOf[placement];
+            return (classOf >> 4) * TWIST_COUNT + m_TwistConjugate[twist][classOf & 15];
+        }
+        int GetEntry(const CubeState& state) const;
+        // The state an entry stands for: the representative's placement and the twist
+        inline int GetPlacement(int entry) const { return m_Representative[entry / TWIST_COUNT]; }
+        inline int GetTwist(int entry) const { return entry % TWIST_COUNT; }
+        // twist seen through one of the U-D symmetries, whatever the placement
+        inline int ConjugateTwist(int twist, int symmetry) const { return m_TwistConjugate[twist][symmetry]; }
+        // Every entry standing for a state symmetric to entry's (entry included, since representatives with
+        // symmetries of their own have several), returns how many: at most UD_COUNT
+        int GetSymmetricEntries(int entry, int* entries) const;
+
+        // Bytes of the conversion tables
+        static size_t GetTableSize() { return sizeof(CornerSymmetry); }
+
+        static int RankPlacement(const unsigned char* cp);
+        static void UnrankPlacement(int placement, unsigned char* cp);
+        static int RankTwist(const unsigned char* co);
+        static void UnrankTwist(int twist, unsigned char* co);
+};
+
+// Sym-coordinate for the 8 U and D layer edges (where each piece is, and its
+// flip), up to the 16 U-D symmetries, which keep those edges among themselves.
+// The slots they take fall into SLOT_SET_CLASS_COUNT classes; a state is stored
+// as seen through the symmetry taking its slots to its class representative's:
+// the piece in each of those slots, in slot order, and the flip of every piece.
+// Representatives that symmetries map onto themselves keep an entry for each
+// symmetric state, as with the corners.
+// The same entries serve the 8 edges around the R-L or the F-B axis, seen
+// through a rotation that brings that axis to U-D.
+//
+// Entries are (class * ARRANGEMENT_COUNT + arrangement) * FLIP_COUNT + flips:
+// 464 million rather than 5.1 billion.
+class EdgeSymmetry
+{
+    public:
+        static const int PIECE_COUNT = 8;             // UR to DB
+        static const int SLOT_SET_CLASS_COUNT = 45;   // Of the 495 sets of 8 slots
+        static const int ARRANGEMENT_COUNT = 40320;   // 8!
+        static const int FLIP_COUNT = 256;            // 2^8
+        static const int ENTRY_COUNT = SLOT_SET_CLASS_COUNT * ARRANGEMENT_COUNT * FLIP_COUNT;
+        static const int AXIS_COUNT = CubeSymmetry::AXIS_COUNT;
+    private:
+        uint16_t m_SlotSetClass[1 << CubeState::EDGE_COUNT]; // [slot mask] class << 4 | symmetry to the representative
+        uint16_t m_Representative[SLOT_SET_CLASS_COUNT];     // Slot mask
+        uint16_t m_Stabilizer[SLOT_SET_CLASS_COUNT];         // Bit set for every symmetry that maps it onto itself
+        // Seen through a symmetry, piece p in slot q becomes piece m_To[p] in slot m_To[q], its flip changed by m_FlipChange[q][p]
+        unsigned char m_To[CubeSymmetry::COUNT][CubeState::EDGE_COUNT];
+        unsigned char m_FlipChange[CubeSymmetry::COUNT][CubeState::EDGE_COUNT][CubeState::EDGE_COUNT];
+        // The pieces CubeSymmetry::GetAxisRotation brings to UR to DB, in that order
+        unsigned char m_AxisPieces[AXIS_COUNT][PIECE_COUNT];
+
+        EdgeSymmetry();
+        // slots and flips of pieces 0 to 7 only
+        int GetGroupEntry(const unsigned char* slots, const unsigned char* flips) const;
+    public:
+        EdgeSymmetry(const EdgeSymmetry&) = delete;
+        EdgeSymmetry& operator=(const EdgeSymmetry&) = delete;
+        // Built on first use, well under a millisecond
+        static const EdgeSymmetry& Get();
+
+        // slots and flips hold the slot each edge piece is in and its flip (pieces rather than slots, as the
+        // optimal solver tracks them). axis 0 takes the U and D layer edges, 1 and 2 those of the R and L or
+        // the F and B layers
+        int GetEntry(const unsigned char* slots, const unsigned char* flips, int axis = 0) const;
+        // The state an entry stands for, as the slots and flips of pieces 0 to 7
+        void GetState(int entry, unsigned char* slots, unsigned char* flips) const;
+        // Every entry standing for a state symmetric to entry's (entry included), returns how many: at most UD_COUNT
+        int GetSymmetricEntries(int entry, int* entries) const;
+
+        // Bytes of the conversion tables
+        static size_t GetTableSize() { return sizeof(EdgeSymmetry); }
+};
@@ -1,4 +1,5 @@
 #include <Debugger.h>
+#include <GLExtensions.h>
 #include <iostream>
 #include <iomanip>
 #include <glm/glm.hpp>
@@ -18,6 +19,50 @@ bool GLLogCall(const char* function, const char* file, int line)
     return true;
 }
 
+std::atomic<const GLCallSite*> g_GLLastCallSite{ nullptr };
+thread_local GLCallSite g_GLCallSite = { "", "", 0 };
+
+#if GL_DEBUG_MODE == GL_DEBUG_CALLBACK || GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+static void APIENTRY GLDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+{
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+        return;
+
+    const char* kind = type == GL_DEBUG_TYPE_ERROR ? "OpenGL Error" : "OpenGL Debug";
+    std::cout << "[" << kind << "] (" << id << "): " << message << std::endl;
+#if GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+    // Output is synchronous (see GLDebugInit), so this runs inside the offending call on its own thread
+    std::cout << "    in " << g_GLCallSite.function << " " << g_GLCallSite.file << ":" << g_GLCallSite.line << std::endl;
+#else
+    // The driver may report well after the call that caused it, only the last GLCall issued is known
+    const GLCallSite* site = g_GLLastCallSite.load(std::memory_order_relaxed);
+    if (site)
+        std::cout << "    near " << site->function << " " << site->file << ":" << site->line
+            << " (last GLCall issued, the error may come from an earlier one)" << std::endl;
+#endif
+}
+#endif
+
+void GLDebugInit(GLADloadproc load)
+{
+    GLExtensions::Load(load);
+
+#if GL_DEBUG_MODE == GL_DEBUG_CALLBACK || GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+    if (!GLExtensions::DebugMessageCallback)
+    {
+        std::cout << "Warning: KHR_debug isn't available, OpenGL errors won't be reported" << std::endl;
+        return;
+    }
+    glEnable(GL_DEBUG_OUTPUT);
+#if GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+    // Messages then come from inside the call that caused them, on the thread that made it, where
+    // g_GLCallSite names that call; drivers may otherwise report later and from a thread of their own
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+#endif
+    GLExtensions::DebugMessageCallback(GLDebugMessage, nullptr);
+#endif
+}
+
 void PrintMatrix(const char* label, const glm::mat4& matrix)
 {
     std::cout << "--- Matrix: " << label << " ---" << std::endl;
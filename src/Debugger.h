@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include <atomic>
 #include <iostream>
 
 // #define ASSERT(x) if (!(x)) __debugbreak();
@@ -18,9 +19,61 @@
 #define ASSERT(x) if (!(x)) raise(SIGTRAP);
 #endif
 
+// GL error checking modes, picked at build time (make GL_DEBUG=off|callback|callback-sync|sync):
+//  OFF           - GLCall is just the call
+//  CALLBACK      - the driver reports errors through glDebugMessageCallback whenever it gets to
+//                  them, GLCall only records its call site so a report can say roughly where it was
+//  CALLBACK_SYNC - as CALLBACK, but with synchronous debug output the driver reports from inside
+//                  the offending call, so the recorded site is exact, at the cost of pipelining
+//  SYNC          - glGetError around every call, a full pipeline round trip each time
+#define GL_DEBUG_OFF 0
+#define GL_DEBUG_CALLBACK 1
+#define GL_DEBUG_SYNC 2
+#define GL_DEBUG_CALLBACK_SYNC 3
+
+#ifndef GL_DEBUG_MODE
+#define GL_DEBUG_MODE GL_DEBUG_SYNC
+#endif
+
+#if GL_DEBUG_MODE == GL_DEBUG_SYNC
 #define GLCall(x) GLClearError();\
     x;\
     ASSERT(GLLogCall(#x, __FILE__, __LINE__));
+#elif GL_DEBUG_MODE == GL_DEBUG_CALLBACK
+#define GLCall(x) { static const GLCallSite s_CallSite = { #x, __FILE__, __LINE__ }; GLSetCallSite(&s_CallSite); }\
+    x;
+#elif GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+#define GLCall(x) GLSetCallSite(#x, __FILE__, __LINE__);\
+    x;
+#else
+#define GLCall(x) x;
+#endif
+
+struct GLCallSite
+{
+    const char* function;
+    const char* file;
+    int line;
+};
+
+// Last GLCall issued, reported alongside debug callback messages. Asynchronous output may arrive
+// later and from a driver thread, so that mode shares one pointer to the static site of the call;
+// synchronous output arrives inside the call, on the thread that made it
+extern std::atomic<const GLCallSite*> g_GLLastCallSite;
+extern thread_local GLCallSite g_GLCallSite;
+
+inline void GLSetCallSite(const GLCallSite* site)
+{
+    g_GLLastCallSite.store(site, std::memory_order_relaxed);
+}
+
+inline void GLSetCallSite(const char* function, const char* file, int line)
+{
+    g_GLCallSite = { function, file, line };
+}
 
 void GLClearError();
-bool GLLogCall(const char* function, const char* file, int line);
\ No newline at end of file
+bool GLLogCall(const char* function, const char* file, int line);
+
+// Hook up error reporting for the selected mode, call once the context is current and glad is loaded
+void GLDebugInit(GLADloadproc load);
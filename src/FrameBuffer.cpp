@@ -0,0 +1,61 @@
+#include <FrameBuffer.h>
+#include <GLState.h>
+#include <FrameCapture.h>
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : m_RendererID(0), m_ColorID(0), m_DepthID(0), m_Width(width), m_Height(height)
+{
+    GLCall(glGenRenderbuffers(1, &m_ColorID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+
+    GLCall(glGenRenderbuffers(1, &m_DepthID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLState::BindFramebuffer(m_RendererID);
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorID));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthID));
+
+    GLCall(unsigned int status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Framebuffer is incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+    }
+    GLState::BindFramebuffer(0);
+}
+
+FrameBuffer::~FrameBuffer()
+{
+    GLState::ForgetFramebuffer(m_RendererID);
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+    GLCall(glDeleteRenderbuffers(1, &m_ColorID));
+    GLCall(glDeleteRenderbuffers(1, &m_DepthID));
+}
+
+void FrameBuffer::Bind() const
+{
+    GLState::BindFramebuffer(m_RendererID);
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void FrameBuffer::Unbind() const
+{
+    GLState::BindFramebuffer(0);
+}
+
+void FrameBuffer::ReadPixels(std::vector<unsigned char>& pixels) const
+{
+    pixels.resize((size_t)m_Width * m_Height * 4);
+    GLState::BindFramebuffer(m_RendererID);
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+}
+
+bool FrameBuffer::WritePNG(const std::string& filepath) const
+{
+    std::vector<unsigned char> pixels;
+    ReadPixels(pixels);
+    return FrameCapture::WritePNG(filepath, m_Width, m_Height, pixels.data());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <string>
+#include <vector>
+
+// FBO with an RGBA8 color and a 24 bit depth renderbuffer
+class FrameBuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_ColorID;
+        unsigned int m_DepthID;
+        int m_Width, m_Height;
+    public:
+        FrameBuffer(int width, int height);
+        ~FrameBuffer();
+
+        // Also sets the viewport to cover the whole framebuffer
+        void Bind() const;
+        void Unbind() const;
+
+        // Blocking read of the color buffer, rows bottom to top.
+        // Use FrameCapture to grab frames continuously without stalling
+        void ReadPixels(std::vector<unsigned char>& pixels) const;
+        bool WritePNG(const std::string& filepath) const;
+
+        inline unsigned int GetRendererID() const { return m_RendererID; }
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+};
@@ -0,0 +1,151 @@
+#include <stb/stb_image_write.h>
+
+#include <FrameCapture.h>
+#include <GLState.h>
+
+#include <algorithm>
+#include <cstring>
+
+// Frames waiting for an encoder before Poll starts holding the frame loop back
+static const size_t s_MaxQueuedJobs = 16;
+
+FrameCapture::FrameCapture(int width, int height, unsigned int ringSize)
+    : m_Width(width), m_Height(height), m_Slots(ringSize), m_Oldest(0), m_InFlight(0), m_Stopping(false)
+{
+    const unsigned int frameSize = (unsigned int)width * height * 4;
+    for (Slot& slot : m_Slots)
+    {
+        slot.fence = nullptr;
+        GLCall(glGenBuffers(1, &slot.pbo));
+        GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, nullptr, GL_STREAM_READ));
+    }
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Encoding is much slower than drawing, keep a few cores on it but leave the render thread alone
+    unsigned int workerCount = std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1;
+    for (unsigned int i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&FrameCapture::WorkerLoop, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_JobAdded.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+
+    for (Slot& slot : m_Slots)
+    {
+        GLState::ForgetBuffer(slot.pbo);
+        GLCall(glDeleteBuffers(1, &slot.pbo));
+    }
+}
+
+void FrameCapture::Capture(unsigned int framebuffer, const std::string& filepath)
+{
+    // Ring is full: the oldest readback has to be collected now, even if that means waiting
+    if (m_InFlight == m_Slots.size())
+        Resolve(m_Slots[m_Oldest]);
+
+    Slot& slot = m_Slots[(m_Oldest + m_InFlight) % m_Slots.size()];
+    slot.filepath = filepath;
+
+    // With a pack buffer bound, glReadPixels only queues a copy into it and returns
+    GLState::BindFramebuffer(framebuffer);
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    GLCall(slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_InFlight++;
+}
+
+void FrameCapture::Poll()
+{
+    // Readbacks complete in order, stop at the first one that isn't done yet
+    while (m_InFlight > 0)
+    {
+        Slot& slot = m_Slots[m_Oldest];
+        GLCall(GLenum status = glClientWaitSync(slot.fence, 0, 0));
+        if (status == GL_TIMEOUT_EXPIRED)
+            break;
+        Resolve(slot);
+    }
+}
+
+void FrameCapture::Flush()
+{
+    while (m_InFlight > 0)
+        Resolve(m_Slots[m_Oldest]);
+}
+
+void FrameCapture::Resolve(Slot& slot)
+{
+    GLenum status;
+    do
+    {
+        GLCall(status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+    } while (status == GL_TIMEOUT_EXPIRED);
+    GLCall(glDeleteSync(slot.fence));
+    slot.fence = nullptr;
+
+    Job job;
+    job.filepath = std::move(slot.filepath);
+    job.pixels.resize((size_t)m_Width * m_Height * 4);
+
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    GLCall(const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, job.pixels.size(), GL_MAP_READ_BIT));
+    if (data)
+        std::memcpy(job.pixels.data(), data, job.pixels.size());
+    GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_Oldest = (m_Oldest + 1) % m_Slots.size();
+    m_InFlight--;
+
+    {
+        // Back pressure: rather than buffering frames without bound, wait for an encoder
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_JobTaken.wait(lock, [this] { return m_Jobs.size() < s_MaxQueuedJobs; });
+        m_Jobs.push_back(std::move(job));
+    }
+    m_JobAdded.notify_one();
+}
+
+void FrameCapture::WorkerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAdded.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+            if (m_Jobs.empty())
+                return;
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+        m_JobTaken.notify_one();
+
+        if (!WritePNG(job.filepath, m_Width, m_Height, job.pixels.data()))
+        {
+            std::cout << "Failed to write " << job.filepath << std::endl;
+        }
+    }
+}
+
+bool FrameCapture::WritePNG(const std::string& filepath, int width, int height, const unsigned char* pixels)
+{
+    // Flip here rather than with stbi_flip_vertically_on_write, which is global state shared by every thread
+    const size_t rowSize = (size_t)width * 4;
+    std::vector<unsigned char> flipped(rowSize * height);
+    for (int y = 0; y < height; y++)
+        std::memcpy(&flipped[rowSize * y], pixels + rowSize * (height - 1 - y), rowSize);
+
+    return stbi_write_png(filepath.c_str(), width, height, 4, flipped.data(), (int)rowSize) != 0;
+}
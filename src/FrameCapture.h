@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reads frames back through a ring of pixel buffer objects. glReadPixels only
+// queues a copy into a PBO, and each PBO is mapped a few frames later once its
+// fence has signaled, so capturing never stalls the pipeline. PNG encoding
+// runs on worker threads.
+class FrameCapture
+{
+    private:
+        struct Slot
+        {
+            unsigned int pbo;
+            GLsync fence;
+            std::string filepath;
+        };
+
+        struct Job
+        {
+            std::string filepath;
+            std::vector<unsigned char> pixels;
+        };
+
+        int m_Width, m_Height;
+        std::vector<Slot> m_Slots;
+        unsigned int m_Oldest;      // Oldest slot with a readback in flight
+        unsigned int m_InFlight;
+
+        std::vector<std::thread> m_Workers;
+        std::mutex m_Mutex;
+        std::condition_variable m_JobAdded;
+        std::condition_variable m_JobTaken;
+        std::deque<Job> m_Jobs;
+        bool m_Stopping;
+
+        void Resolve(Slot& slot);
+        void WorkerLoop();
+    public:
+        FrameCapture(int width, int height, unsigned int ringSize = 3);
+        // Writes out every frame still in flight
+        ~FrameCapture();
+
+        // Queue a readback of the framebuffer's color buffer (0 = back buffer of the window),
+        // call after the frame is drawn and before it is swapped
+        void Capture(unsigned int framebuffer, const std::string& filepath);
+
+        // Hand finished readbacks to the encoder without waiting on the GPU, call once per frame
+        void Poll();
+
+        // Wait for every readback in flight and queue it for encoding
+        void Flush();
+
+        // Write RGBA8 pixels whose rows run bottom to top, the way GL returns them
+        static bool WritePNG(const std::string& filepath, int width, int height, const unsigned char* pixels);
+};
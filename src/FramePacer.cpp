@@ -0,0 +1,78 @@
+#include <FramePacer.h>
+#include <Debugger.h>
+#include <Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Bounds of the spin margin: the least any scheduler needs, and the most worth burning a core on
+static const int64_t s_MinSpinNs = 200000;
+static const int64_t s_MaxSpinNs = 4000000;
+
+static int64_t ClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool ParsePresentMode(const std::string& name, PresentMode& mode)
+{
+    if (name == "vsync")
+        mode = PresentMode::VSync;
+    else if (name == "adaptive")
+        mode = PresentMode::Adaptive;
+    else if (name == "uncapped")
+        mode = PresentMode::Uncapped;
+    else if (name == "limit")
+        mode = PresentMode::Limited;
+    else
+        return false;
+    return true;
+}
+
+const char* GetPresentModeName(PresentMode mode)
+{
+    switch (mode)
+    {
+        case PresentMode::VSync: return "vsync";
+        case PresentMode::Adaptive: return "adaptive";
+        case PresentMode::Uncapped: return "uncapped";
+        case PresentMode::Limited: return "limit";
+    }
+    return "";
+}
+
+FramePacer::FramePacer(double framesPerSecond)
+    : m_PeriodNs((int64_t)(1e9 / framesPerSecond)), m_NextNs(0), m_SpinNs(1000000), m_LateNs(0), m_Frames(0)
+{
+    ASSERT(framesPerSecond > 0.0);
+}
+
+void FramePacer::Wait()
+{
+    PROFILE_SCOPE("FramePacer");
+    int64_t now = ClockNs();
+    // The first frame, and any frame that started past its deadline, set the schedule from now
+    m_NextNs = m_NextNs == 0 ? now : std::max(m_NextNs + m_PeriodNs, now);
+
+    const int64_t wakeNs = m_NextNs - m_SpinNs;
+    if (now < wakeNs)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wakeNs - now));
+        now = ClockNs();
+        // Woken later than the margin allows for: widen it at once. Otherwise let it shrink slowly
+        const int64_t overslept = now - wakeNs;
+        if (overslept * 2 > m_SpinNs)
+            m_SpinNs = std::min(overslept * 2, s_MaxSpinNs);
+        else
+            m_SpinNs = std::max(m_SpinNs - m_SpinNs / 16, s_MinSpinNs);
+    }
+    while (now < m_NextNs)
+    {
+        std::this_thread::yield();
+        now = ClockNs();
+    }
+
+    m_LateNs += now - m_NextNs;
+    m_Frames++;
+}
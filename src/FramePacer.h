@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// How frames reach the screen
+enum class PresentMode
+{
+    VSync,    // Swap on every vertical blank (swap interval 1)
+    Adaptive, // Like VSync, but a frame that misses the blank is shown right away and may tear (swap interval -1)
+    Uncapped, // Swap as soon as a frame is done (swap interval 0), for measuring throughput
+    Limited   // Uncapped swaps, frames started at a fixed rate by FramePacer
+};
+
+// "vsync", "adaptive", "uncapped" or "limit"; false on anything else
+bool ParsePresentMode(const std::string& name, PresentMode& mode);
+const char* GetPresentModeName(PresentMode mode);
+
+// Starts frames at a fixed rate. Wait sleeps through most of the time left in the
+// frame and spins through the rest, so frames start within microseconds of their
+// deadline even where the OS wakes sleepers a millisecond or more late. The spin
+// margin follows how late sleeps actually wake.
+// A frame that runs late moves the schedule back instead of being caught up on
+// with a burst of short frames.
+class FramePacer
+{
+    private:
+        int64_t m_PeriodNs;
+        int64_t m_NextNs;   // Deadline of the next frame, 0 before the first
+        int64_t m_SpinNs;   // Woken this long before the deadline, then spun
+        int64_t m_LateNs;   // Sum of how late frames started, for GetAverageLateness
+        uint64_t m_Frames;
+    public:
+        explicit FramePacer(double framesPerSecond);
+
+        // Until the next frame is due, call at the start of every frame
+        void Wait();
+
+        inline double GetPeriodSeconds() const { return m_PeriodNs * 1e-9; }
+        // How late, on average, Wait returned past a deadline it could meet
+        inline double GetAverageLateness() const { return m_Frames ? m_LateNs * 1e-9 / m_Frames : 0.0; }
+};
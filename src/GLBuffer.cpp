@@ -0,0 +1,157 @@
+#include <GLBuffer.h>
+#include <GLExtensions.h>
+#include <GLState.h>
+
+#include <cstring>
+
+// Frames the CPU may run ahead of the GPU in Persistent mode
+static const unsigned int s_PersistentSegments = 3;
+// Keeps every segment aligned for any attribute type
+static const unsigned int s_SegmentAlignment = 256;
+
+static GLenum ToGLUsage(BufferUsage usage)
+{
+    switch (usage)
+    {
+    case BufferUsage::Static:
+        return GL_STATIC_DRAW;
+    case BufferUsage::Dynamic:
+        return GL_DYNAMIC_DRAW;
+    default:
+        return GL_STREAM_DRAW;
+    }
+}
+
+GLBuffer::GLBuffer(const void* data, unsigned int size, BufferUsage usage)
+    : m_Size(size), m_Usage(usage), m_SegmentStride(0), m_Segment(0), m_Persistent(nullptr), m_Mapped(false), m_RendererID(0)
+{
+    if (m_Usage == BufferUsage::Persistent && !GLExtensions::BufferStorage)
+        m_Usage = BufferUsage::Stream;
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    BindForWrite();
+    if (m_Usage == BufferUsage::Persistent)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        m_SegmentStride = (size + s_SegmentAlignment - 1) / s_SegmentAlignment * s_SegmentAlignment;
+        m_Fences.assign(s_PersistentSegments, nullptr);
+        GLCall(GLExtensions::BufferStorage(GL_COPY_WRITE_BUFFER, m_SegmentStride * s_PersistentSegments, nullptr, flags));
+        GLCall(m_Persistent = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_SegmentStride * s_PersistentSegments, flags));
+        // Later frames start from a different segment, so the initial data goes into all of them
+        if (data)
+        {
+            for (unsigned int segment = 0; segment < s_PersistentSegments; segment++)
+                std::memcpy(m_Persistent + segment * m_SegmentStride, data, size);
+        }
+    }
+    else
+    {
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, data, ToGLUsage(m_Usage)));
+    }
+}
+
+GLBuffer::~GLBuffer()
+{
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+        {
+            GLCall(glDeleteSync(fence));
+        }
+    }
+    // Deleting the buffer also unmaps it
+    GLState::ForgetBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void GLBuffer::BindForWrite() const
+{
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+}
+
+void GLBuffer::WaitForSegment()
+{
+    // Three segments in, the GPU is normally long done and this returns at once
+    if (GLsync fence = m_Fences[m_Segment])
+    {
+        GLenum result;
+        do
+        {
+            GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+        } while (result == GL_TIMEOUT_EXPIRED);
+        GLCall(glDeleteSync(fence));
+        m_Fences[m_Segment] = nullptr;
+    }
+}
+
+void GLBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    ASSERT(!m_Mapped);
+
+    switch (m_Usage)
+    {
+    case BufferUsage::Persistent:
+        WaitForSegment();
+        std::memcpy(m_Persistent + GetOffset() + offset, data, size);
+        break;
+    case BufferUsage::Stream:
+        BindForWrite();
+        if (offset == 0)
+        {
+            // Orphan: the driver hands out a new store while draws still in flight keep the old one
+            GLCall(glBufferData(GL_COPY_WRITE_BUFFER, m_Size, size == m_Size ? data : nullptr, GL_STREAM_DRAW));
+            if (size == m_Size)
+                break;
+        }
+        GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+        break;
+    default:
+        BindForWrite();
+        GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+        break;
+    }
+    GLState::CountUpload(size);
+}
+
+void* GLBuffer::Map()
+{
+    ASSERT(!m_Mapped);
+    m_Mapped = true;
+
+    if (m_Usage == BufferUsage::Persistent)
+    {
+        WaitForSegment();
+        return m_Persistent + GetOffset();
+    }
+
+    // Streaming maps orphan the store, the others wait for pending draws like glBufferSubData would
+    const GLbitfield access = GL_MAP_WRITE_BIT | (m_Usage == BufferUsage::Stream ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_INVALIDATE_RANGE_BIT);
+    BindForWrite();
+    GLCall(void* dst = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_Size, access));
+    return dst;
+}
+
+void GLBuffer::Unmap(unsigned int bytesWritten)
+{
+    ASSERT(m_Mapped);
+    ASSERT(bytesWritten <= m_Size);
+    m_Mapped = false;
+
+    // Coherent persistent memory is already visible to the GPU
+    if (m_Usage != BufferUsage::Persistent)
+    {
+        BindForWrite();
+        GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+    }
+    GLState::CountUpload(bytesWritten);
+}
+
+void GLBuffer::EndFrame()
+{
+    if (m_Usage != BufferUsage::Persistent)
+        return;
+
+    GLCall(m_Fences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_Segment = (m_Segment + 1) % s_PersistentSegments;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <vector>
+
+// How a buffer's contents are expected to change
+enum class BufferUsage
+{
+    Static,     // written once, SetData for the odd update
+    Dynamic,    // updated in place with glBufferSubData
+    Stream,     // rewritten every frame, each rewrite orphans the old store
+    Persistent  // ring of per-frame segments in one persistently mapped store, every frame writes its data in full
+                // (falls back to Stream without GL 4.4 / ARB_buffer_storage)
+};
+
+// Storage shared by VertexBuffer and IndexBuffer. Uploads go through
+// GL_COPY_WRITE_BUFFER so they never disturb the bound VAO's element buffer.
+//
+// In Persistent mode the store holds one segment of `size` bytes per frame in
+// flight. Writes land in the current segment (after waiting on its fence),
+// EndFrame fences it and moves on, and users read the segment's position from
+// GetOffset(): VertexArray re-points its attributes, index draws pass it as the
+// indices offset.
+class GLBuffer
+{
+    private:
+        unsigned int m_Size;
+        BufferUsage m_Usage;
+        unsigned int m_SegmentStride;
+        unsigned int m_Segment;
+        unsigned char* m_Persistent;
+        std::vector<GLsync> m_Fences;
+        bool m_Mapped;
+
+        void BindForWrite() const;
+        void WaitForSegment();
+    protected:
+        unsigned int m_RendererID;
+
+        GLBuffer(const void* data, unsigned int size, BufferUsage usage);
+        ~GLBuffer();
+    public:
+        // Overwrite part of this frame's data (must fit in the size it was created with).
+        // In Stream mode a write at offset 0 starts over in a fresh store
+        void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+        // Write this frame's data in place, then Unmap with the number of bytes written.
+        // Persistent mode hands out the mapped segment directly, with no map call at all
+        void* Map();
+        void Unmap(unsigned int bytesWritten);
+
+        // Fence the current segment once the draws reading it have been submitted (Persistent mode only)
+        void EndFrame();
+
+        // Byte offset of the data the next draw reads, always 0 outside Persistent mode
+        inline unsigned int GetOffset() const { return m_Segment * m_SegmentStride; }
+        inline unsigned int GetSize() const { return m_Size; }
+        inline BufferUsage GetUsage() const { return m_Usage; }
+};
@@ -0,0 +1,38 @@
+#include <GLExtensions.h>
+
+#include <cstring>
+
+PFNGLDEBUGMESSAGECALLBACKEXTPROC GLExtensions::DebugMessageCallback = nullptr;
+PFNGLBUFFERSTORAGEEXTPROC GLExtensions::BufferStorage = nullptr;
+
+void GLExtensions::Load(GLADloadproc load)
+{
+    if (IsVersionAtLeast(4, 3) || IsSupported("GL_KHR_debug"))
+        DebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKEXTPROC)load("glDebugMessageCallback");
+    else if (IsSupported("GL_ARB_debug_output"))
+        DebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKEXTPROC)load("glDebugMessageCallbackARB");
+
+    if (IsVersionAtLeast(4, 4) || IsSupported("GL_ARB_buffer_storage"))
+        BufferStorage = (PFNGLBUFFERSTORAGEEXTPROC)load("glBufferStorage");
+}
+
+bool GLExtensions::IsSupported(const char* extension)
+{
+    int count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (int i = 0; i < count; i++)
+    {
+        const char* name = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (name && std::strcmp(name, extension) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool GLExtensions::IsVersionAtLeast(int major, int minor)
+{
+    int contextMajor = 0, contextMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &contextMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &contextMinor);
+    return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Enums from GL_KHR_debug (core in 4.3), glad was generated for plain 3.3 core
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+// Enums from GL_ARB_buffer_storage (core in 4.4)
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECALLBACKEXTPROC)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEEXTPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// Entry points beyond the 3.3 core profile, loaded at runtime when the driver offers them.
+// A null pointer means the feature is unavailable
+class GLExtensions
+{
+    public:
+        static PFNGLDEBUGMESSAGECALLBACKEXTPROC DebugMessageCallback;
+        static PFNGLBUFFERSTORAGEEXTPROC BufferStorage;
+
+        // Call once the context is current and glad is loaded
+        static void Load(GLADloadproc load);
+
+        static bool IsSupported(const char* extension);
+        static bool IsVersionAtLeast(int major, int minor);
+};
@@ -0,0 +1,185 @@
+#include <GLState.h>
+
+unsigned int GLState::s_Program = GLState::s_Unknown;
+unsigned int GLState::s_Framebuffer = GLState::s_Unknown;
+unsigned int GLState::s_VertexArray = GLState::s_Unknown;
+unsigned int GLState::s_ArrayBuffer = GLState::s_Unknown;
+unsigned int GLState::s_UniformBuffer = GLState::s_Unknown;
+unsigned int GLState::s_PixelPackBuffer = GLState::s_Unknown;
+unsigned int GLState::s_CopyWriteBuffer = GLState::s_Unknown;
+unsigned int GLState::s_ActiveTextureUnit = GLState::s_Unknown;
+unsigned int GLState::s_Textures[GLState::s_MaxTextureUnits] = {
+    s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown,
+    s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown,
+    s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown,
+    s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown
+};
+std::unordered_map<unsigned int, unsigned int> GLState::s_ElementBuffers;
+
+GLStateCounters GLState::s_FrameCounters;
+GLStateCounters GLState::s_LastFrameCounters;
+
+unsigned int* GLState::GetBufferSlot(unsigned int target)
+{
+    switch (target)
+    {
+    case GL_ARRAY_BUFFER:
+        return &s_ArrayBuffer;
+    case GL_UNIFORM_BUFFER:
+        return &s_UniformBuffer;
+    case GL_PIXEL_PACK_BUFFER:
+        return &s_PixelPackBuffer;
+    case GL_COPY_WRITE_BUFFER:
+        return &s_CopyWriteBuffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+    {
+        // Unknown VAO means unknown element buffer too
+        if (s_VertexArray == s_Unknown)
+            return nullptr;
+        auto it = s_ElementBuffers.find(s_VertexArray);
+        if (it == s_ElementBuffers.end())
+            it = s_ElementBuffers.emplace(s_VertexArray, s_Unknown).first;
+        return &it->second;
+    }
+    }
+    return nullptr;
+}
+
+void GLState::UseProgram(unsigned int id)
+{
+    if (s_Program == id)
+    {
+        s_FrameCounters.skipped++;
+        return;
+    }
+    GLCall(glUseProgram(id));
+    s_Program = id;
+    s_FrameCounters.issued++;
+}
+
+void GLState::BindFramebuffer(unsigned int id)
+{
+    if (s_Framebuffer == id)
+    {
+        s_FrameCounters.skipped++;
+        return;
+    }
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, id));
+    s_Framebuffer = id;
+    s_FrameCounters.issued++;
+}
+
+void GLState::BindVertexArray(unsigned int id)
+{
+    if (s_VertexArray == id)
+    {
+        s_FrameCounters.skipped++;
+        return;
+    }
+    GLCall(glBindVertexArray(id));
+    s_VertexArray = id;
+    s_FrameCounters.issued++;
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int id)
+{
+    unsigned int* bound = GetBufferSlot(target);
+    if (bound && *bound == id)
+    {
+        s_FrameCounters.skipped++;
+        return;
+    }
+    GLCall(glBindBuffer(target, id));
+    if (bound)
+        *bound = id;
+    s_FrameCounters.issued++;
+}
+
+void GLState::BindBufferRange(unsigned int target, unsigned int index, unsigned int id, long long offset, long long size)
+{
+    // Indexed bindings move every frame, only the generic binding they also set is tracked
+    GLCall(glBindBufferRange(target, index, id, (GLintptr)offset, (GLsizeiptr)size));
+    if (unsigned int* bound = GetBufferSlot(target))
+        *bound = id;
+    s_FrameCounters.issued++;
+}
+
+void GLState::BindTexture(unsigned int slot, unsigned int id)
+{
+    ASSERT(slot < s_MaxTextureUnits);
+    if (s_Textures[slot] == id)
+    {
+        s_FrameCounters.skipped++;
+        return;
+    }
+    if (s_ActiveTextureUnit != slot)
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+        s_ActiveTextureUnit = slot;
+        s_FrameCounters.issued++;
+    }
+    GLCall(glBindTexture(GL_TEXTURE_2D, id));
+    s_Textures[slot] = id;
+    s_FrameCounters.issued++;
+}
+
+void GLState::UnbindTexture(unsigned int id)
+{
+    for (unsigned int slot = 0; slot < s_MaxTextureUnits; slot++)
+    {
+        if (s_Textures[slot] == id)
+            BindTexture(slot, 0);
+    }
+}
+
+void GLState::ForgetProgram(unsigned int id)
+{
+    // A deleted program stays in use until another one is bound, so force the next bind through
+    if (s_Program == id)
+        s_Program = s_Unknown;
+}
+
+void GLState::ForgetFramebuffer(unsigned int id)
+{
+    // Deleting the bound framebuffer reverts the binding to the default one
+    if (s_Framebuffer == id)
+        s_Framebuffer = 0;
+}
+
+void GLState::ForgetVertexArray(unsigned int id)
+{
+    // Deleting the bound VAO reverts the binding to zero
+    if (s_VertexArray == id)
+        s_VertexArray = 0;
+    s_ElementBuffers.erase(id);
+}
+
+void GLState::ForgetBuffer(unsigned int id)
+{
+    // Deleting a bound buffer reverts its bindings to zero
+    for (unsigned int* bound : { &s_ArrayBuffer, &s_UniformBuffer, &s_PixelPackBuffer, &s_CopyWriteBuffer })
+    {
+        if (*bound == id)
+            *bound = 0;
+    }
+    for (auto& elementBuffer : s_ElementBuffers)
+    {
+        if (elementBuffer.second == id)
+            elementBuffer.second = 0;
+    }
+}
+
+void GLState::ForgetTexture(unsigned int id)
+{
+    for (unsigned int& bound : s_Textures)
+    {
+        if (bound == id)
+            bound = 0;
+    }
+}
+
+void GLState::EndFrame()
+{
+    s_LastFrameCounters = s_FrameCounters;
+    s_FrameCounters = GLStateCounters();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <unordered_map>
+
+// Number of binding calls sent to the driver and dropped as redundant,
+// along with the draw calls and buffer bytes uploaded in the same frame
+struct GLStateCounters
+{
+    unsigned int issued = 0;
+    unsigned int skipped = 0;
+    unsigned int drawCalls = 0;
+    unsigned long long bytesUploaded = 0;
+};
+
+// Shadow copy of the bound GL objects, shared by every wrapper in src/, so a
+// bind that would not change anything never reaches the driver.
+// All wrappers must bind through here or the shadow copy goes stale.
+class GLState
+{
+    private:
+        static constexpr unsigned int s_Unknown = ~0u;
+        static constexpr unsigned int s_MaxTextureUnits = 32;
+
+        static unsigned int s_Program;
+        static unsigned int s_Framebuffer;
+        static unsigned int s_VertexArray;
+        static unsigned int s_ArrayBuffer;
+        static unsigned int s_UniformBuffer;
+        static unsigned int s_PixelPackBuffer;
+        static unsigned int s_CopyWriteBuffer;
+        static unsigned int s_ActiveTextureUnit;
+        static unsigned int s_Textures[s_MaxTextureUnits];
+        // The element buffer binding is part of the VAO, so it is tracked per VAO
+        static std::unordered_map<unsigned int, unsigned int> s_ElementBuffers;
+
+        static GLStateCounters s_FrameCounters;
+        static GLStateCounters s_LastFrameCounters;
+
+        static unsigned int* GetBufferSlot(unsigned int target);
+    public:
+        static void UseProgram(unsigned int id);
+        static void BindFramebuffer(unsigned int id);
+        static void BindVertexArray(unsigned int id);
+        static void BindBuffer(unsigned int target, unsigned int id);
+        static void BindBufferRange(unsigned int target, unsigned int index, unsigned int id, long long offset, long long size);
+        static void BindTexture(unsigned int slot, unsigned int id);
+        // Unbind a texture from every unit it is bound to
+        static void UnbindTexture(unsigned int id);
+
+        // Call before deleting an object so its recycled name isn't mistaken for a bound one
+        static void ForgetProgram(unsigned int id);
+        static void ForgetFramebuffer(unsigned int id);
+        static void ForgetVertexArray(unsigned int id);
+        static void ForgetBuffer(unsigned int id);
+        static void ForgetTexture(unsigned int id);
+
+        inline static void CountDraw() { s_FrameCounters.drawCalls++; }
+        inline static void CountUpload(unsigned long long bytes) { s_FrameCounters.bytesUploaded += bytes; }
+
+        // Close the frame's counters and start counting the next frame
+        static void EndFrame();
+
+        inline static const GLStateCounters& GetFrameCounters() { return s_LastFrameCounters; }
+};
@@ -0,0 +1,105 @@
+#include <HeadlessContext.h>
+#include <Debugger.h>
+
+#include <iostream>
+
+#if defined(__linux__)
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+    // Prefer the surfaceless platform, it needs neither X11 nor a DRM device
+    EGLDisplay display = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cout << "Failed to initialize EGL (0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        return;
+    }
+    m_Display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cout << "EGL " << major << "." << minor << " has no desktop OpenGL support" << std::endl;
+        return;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#if GL_DEBUG_MODE == GL_DEBUG_CALLBACK || GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+        EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+        EGL_NONE
+    };
+
+    // No config and no surface: everything is drawn into FBOs
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cout << "Failed to create a headless OpenGL context (0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        return;
+    }
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cout << "Failed to make the headless OpenGL context current" << std::endl;
+        eglDestroyContext(display, context);
+        return;
+    }
+    m_Context = context;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (m_Context)
+    {
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_Display, m_Context);
+    }
+    if (m_Display)
+        eglTerminate(m_Display);
+}
+
+void HeadlessContext::MakeCurrent(bool current)
+{
+    if (m_Context && !eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, current ? m_Context : EGL_NO_CONTEXT))
+        std::cout << "Failed to " << (current ? "make the headless OpenGL context current" : "release the headless OpenGL context") << std::endl;
+}
+
+void* HeadlessContext::GetProcAddress(const char* name)
+{
+    return (void*)eglGetProcAddress(name);
+}
+
+#else
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+    std::cout << "Headless rendering needs EGL, which is only set up on Linux" << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+}
+
+void HeadlessContext::MakeCurrent(bool current)
+{
+}
+
+void* HeadlessContext::GetProcAddress(const char* name)
+{
+    return nullptr;
+}
+
+#endif
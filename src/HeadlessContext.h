@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// OpenGL 3.3 core context with no window, created through EGL on Mesa's
+// surfaceless platform (llvmpipe works, no GPU or display needed).
+// There is no default framebuffer, render into a FrameBuffer instead
+class HeadlessContext
+{
+    private:
+        void* m_Display;
+        void* m_Context;
+    public:
+        HeadlessContext();
+        ~HeadlessContext();
+
+        inline bool IsValid() const { return m_Context != nullptr; }
+
+        // Make the context current on the calling thread, or release it so another thread can take it
+        void MakeCurrent(bool current);
+
+        // Loader for glad and GLDebugInit
+        static void* GetProcAddress(const char* name);
+};
@@ -1,26 +1,24 @@
 #include <IndexBuffer.h>
+#include <GLState.h>
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int size)
-    : m_Count(size / sizeof(unsigned int))
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int size, BufferUsage usage)
+    : GLBuffer(data, size, usage), m_Count(size / sizeof(unsigned int))
 {
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
-
-    GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
-IndexBuffer::~IndexBuffer()
+void IndexBuffer::SetData(const unsigned int* data, unsigned int size)
 {
-    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GLBuffer::SetData(data, size);
+    m_Count = size / sizeof(unsigned int);
 }
 
 void IndexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
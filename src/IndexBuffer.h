@@ -1,19 +1,27 @@
 #pragma once
 
 #include <Debugger.h>
+#include <GLBuffer.h>
+
+#include <cstdint>
 
 // EBO
-class IndexBuffer
+class IndexBuffer : public GLBuffer
 {
     private:
-        unsigned int m_RendererID;
         unsigned int m_Count;
     public:
-        IndexBuffer(const unsigned int* data, unsigned int size);
-        ~IndexBuffer();
+        IndexBuffer(const unsigned int* data, unsigned int size, BufferUsage usage = BufferUsage::Static);
+
+        // Replace the indices from the start, size is in bytes
+        void SetData(const unsigned int* data, unsigned int size);
 
         void Bind() const;
         void Unbind() const;
 
+        // After filling the buffer through Map
+        inline void SetCount(unsigned int count) { m_Count = count; }
         inline unsigned int GetCount() const { return m_Count; }
-};
\ No newline at end of file
+        // Pass as the indices argument of glDrawElements
+        inline const void* GetIndicesOffset() const { return reinterpret_cast<const void*>(static_cast<uintptr_t>(GetOffset())); }
+};
@@ -0,0 +1,151 @@
+#include <InputLatency.h>
+#include <Statistics.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+bool InputLatency::s_Enabled = false;
+std::mutex InputLatency::s_Mutex;
+std::vector<InputLatency::KeyEvent> InputLatency::s_Events;
+size_t InputLatency::s_NextSubmitted = 0;
+size_t InputLatency::s_NextPresented = 0;
+std::set<uint64_t> InputLatency::s_StartedTurns;
+
+static std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+// Milliseconds between two stamps
+static double Milliseconds(uint64_t from, uint64_t to)
+{
+    return (double)(to - from) * 1e-6;
+}
+
+void InputLatency::Init()
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Epoch = std::chrono::steady_clock::now();
+    s_Events.clear();
+    s_Events.reserve(1024);
+    s_NextSubmitted = 0;
+    s_NextPresented = 0;
+    s_StartedTurns.clear();
+    s_Enabled = true;
+}
+
+uint64_t InputLatency::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+}
+
+void InputLatency::RecordKey(int key, int action, uint64_t pressed, uint64_t turn)
+{
+    if (!s_Enabled)
+        return;
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Events.push_back({ key, action, turn, pressed, 0, 0, -1 });
+}
+
+void InputLatency::TurnStarted(uint64_t turn)
+{
+    if (!s_Enabled)
+        return;
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_StartedTurns.insert(turn);
+}
+
+// Only asked once the turn is settled, so its start has been reported if it ever will be
+bool InputLatency::HasStarted(KeyEvent& event)
+{
+    if (event.started < 0)
+    {
+        // Events come in turn order, so lower numbers are settled already or were queued by no key (scripts)
+        s_StartedTurns.erase(s_StartedTurns.begin(), s_StartedTurns.lower_bound(event.turn));
+        event.started = s_StartedTurns.erase(event.turn) > 0;
+    }
+    return event.started > 0;
+}
+
+void InputLatency::MarkFrame(uint64_t turnsSettled, size_t& next, uint64_t KeyEvent::*stamp)
+{
+    if (!s_Enabled)
+        return;
+    const uint64_t now = Now();
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    // Turns are queued in the order their keys came in, so the events this frame settles are a run from next
+    for (; next < s_Events.size(); next++)
+    {
+        KeyEvent& event = s_Events[next];
+        if (event.turn > turnsSettled)
+            break;
+        if (event.turn && HasStarted(event))
+            event.*stamp = now;
+    }
+}
+
+void InputLatency::FrameSubmitted(uint64_t turnsSettled)
+{
+    MarkFrame(turnsSettled, s_NextSubmitted, &KeyEvent::submitted);
+}
+
+void InputLatency::FramePresented(uint64_t turnsSettled)
+{
+    MarkFrame(turnsSettled, s_NextPresented, &KeyEvent::presented);
+}
+
+bool InputLatency::WriteReport(const std::string& filepath)
+{
+    if (!s_Enabled)
+        return true;
+    std::lock_guard<std::mutex> lock(s_Mutex);
+
+    std::vector<double> toSubmitted, toPresented;
+    size_t turned = 0, withoutEffect = 0;
+    for (const KeyEvent& event : s_Events)
+    {
+        turned += event.turn != 0;
+        withoutEffect += event.turn != 0 && event.started == 0;
+        if (event.submitted)
+            toSubmitted.push_back(Milliseconds(event.pressed, event.submitted));
+        if (event.presented)
+            toPresented.push_back(Milliseconds(event.pressed, event.presented));
+    }
+    std::sort(toSubmitted.begin(), toSubmitted.end());
+    std::sort(toPresented.begin(), toPresented.end());
+
+    std::cout << "Input latency: " << s_Events.size() << " key events, " << turned << " queued a turn, " << withoutEffect
+        << " of those merged, cancelled or dropped before they showed" << std::endl;
+    if (!toSubmitted.empty())
+    {
+        std::cout << "  key to submitted: " << Percentile(toSubmitted, 50) << " ms median, " << Percentile(toSubmitted, 95)
+            << " ms p95, " << toSubmitted.back() << " ms max" << std::endl;
+    }
+    if (!toPresented.empty())
+    {
+        std::cout << "  key to presented: " << Percentile(toPresented, 50) << " ms median, " << Percentile(toPresented, 95)
+            << " ms p95, " << toPresented.back() << " ms max" << std::endl;
+    }
+
+    if (filepath.empty())
+        return true;
+    std::ofstream file(filepath);
+    // One row per event, times in milliseconds since Init; the last columns are empty for events without an effect
+    file << "key,action,turn,pressed_ms,submitted_ms,presented_ms,to_submitted_ms,to_presented_ms\n";
+    for (const KeyEvent& event : s_Events)
+    {
+        file << event.key << "," << event.action << "," << event.turn << "," << event.pressed * 1e-6 << ",";
+        if (event.submitted)
+            file << event.submitted * 1e-6;
+        file << ",";
+        if (event.presented)
+            file << event.presented * 1e-6;
+        file << ",";
+        if (event.submitted)
+            file << Milliseconds(event.pressed, event.submitted);
+        file << ",";
+        if (event.presented)
+            file << Milliseconds(event.pressed, event.presented);
+        file << "\n";
+    }
+    return (bool)file;
+}
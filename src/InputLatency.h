@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Follows every key event from the moment its callback runs to the first frame
+// that shows its effect: when that frame's commands were submitted to GL and when
+// its swap returned (presented). A key that queues a turn takes effect in the first
+// frame drawn from a simulation step that started the turn animating. Turns are
+// numbered in the order they are queued (GetQueuedTurnCount), the simulation
+// reports each one it starts, and a frame knows every turn up to which number has
+// started or never will (CubeSnapshot::turnsSettled). A turn merged into a later
+// one, cancelled or dropped at a locked wall has no effect, nor do other keys.
+// Everything is a no-op until Init is called.
+class InputLatency
+{
+    private:
+        struct KeyEvent
+        {
+            int key;
+            int action;
+            uint64_t turn;        // Turns queued once this key's turn was, 0 when it queued none
+            uint64_t pressed;     // Nanoseconds since Init
+            uint64_t submitted;   // 0 until a frame shows the effect
+            uint64_t presented;
+            int started;          // Whether the turn started animating, -1 until that is known
+        };
+
+        static bool s_Enabled;
+        static std::mutex s_Mutex;
+        static std::vector<KeyEvent> s_Events;
+        // Oldest events with an effect not submitted / presented yet
+        static size_t s_NextSubmitted;
+        static size_t s_NextPresented;
+        // Turns reported by TurnStarted and not matched with their key event yet
+        static std::set<uint64_t> s_StartedTurns;
+
+        static bool HasStarted(KeyEvent& event);
+        static void MarkFrame(uint64_t turnsSettled, size_t& next, uint64_t KeyEvent::*stamp);
+    public:
+        static void Init();
+        inline static bool IsEnabled() { return s_Enabled; }
+        // Nanoseconds since Init
+        static uint64_t Now();
+
+        // A key event that came in at pressed (see Now); turn is GetQueuedTurnCount() after the turn it
+        // queued, 0 when it queued none. Events have to be recorded in the order they came in
+        static void RecordKey(int key, int action, uint64_t pressed, uint64_t turn);
+
+        // From the simulation: the turn numbered turn (see RecordKey) started animating
+        static void TurnStarted(uint64_t turn);
+
+        // From the render thread: a frame drawn from a snapshot with turnsSettled (see CubeSnapshot) was
+        // submitted / presented
+        static void FrameSubmitted(uint64_t turnsSettled);
+        static void FramePresented(uint64_t turnsSettled);
+
+        // A summary on stdout, and every event as CSV at filepath (none when empty)
+        static bool WriteReport(const std::string& filepath);
+};
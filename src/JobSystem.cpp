@@ -0,0 +1,123 @@
+#include <JobSystem.h>
+#include <Debugger.h>
+
+// The pool and worker the calling thread belongs to
+static thread_local const JobSystem* t_Pool = nullptr;
+static thread_local int t_WorkerIndex = -1;
+
+JobSystem::JobSystem(int threadCount)
+    : m_Queued(0), m_Unfinished(0), m_NextWorker(0), m_Stopping(false)
+{
+    if (threadCount <= 0)
+        threadCount = GetDefaultThreadCount();
+    for (int i = 0; i < threadCount; i++)
+        m_Workers.emplace_back(new Worker());
+    // Only once every deque exists, since workers steal from all of them
+    for (int i = 0; i < threadCount; i++)
+        m_Threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stopping = true;
+    }
+    m_WakeUp.notify_all();
+    for (std::thread& thread : m_Threads)
+        thread.join();
+    ASSERT(m_Unfinished == 0);
+}
+
+void JobSystem::Submit(Job job)
+{
+    const int worker = t_Pool == this ? t_WorkerIndex : (int)(m_NextWorker++ % m_Workers.size());
+    // Counted before the push: a thief can run the job, and take it off both counts, as soon as it is in the deque
+    m_Unfinished++;
+    m_Queued++;
+    {
+        std::lock_guard<std::mutex> lock(m_Workers[worker]->mutex);
+        m_Workers[worker]->jobs.push_back(std::move(job));
+    }
+    // Taking the lock orders this with a worker that just found nothing and is about to sleep
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_WakeUp.notify_one();
+}
+
+bool JobSystem::RunOne(int self)
+{
+    Job job;
+    if (self >= 0)
+    {
+        Worker& own = *m_Workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+        }
+    }
+    // Steal, starting from the next worker so thieves spread out
+    for (size_t i = 1; !job && i <= m_Workers.size(); i++)
+    {
+        Worker& victim = *m_Workers[(self + i) % m_Workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+        }
+    }
+    if (!job)
+        return false;
+
+    m_Queued--;
+    job();
+    if (--m_Unfinished == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_AllDone.notify_all();
+    }
+    return true;
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+    t_Pool = this;
+    t_WorkerIndex = index;
+    for (;;)
+    {
+        if (RunOne(index))
+            continue;
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_WakeUp.wait(lock, [this]() { return m_Stopping || m_Queued > 0; });
+        if (m_Stopping && m_Queued == 0)
+            return;
+    }
+}
+
+void JobSystem::Wait()
+{
+    const int self = t_Pool == this ? t_WorkerIndex : -1;
+    while (m_Unfinished > 0)
+    {
+        if (RunOne(self))
+            continue;
+        // Everything left is running on some worker
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_AllDone.wait(lock, [this]() { return m_Unfinished == 0 || m_Queued > 0; });
+    }
+}
+
+int JobSystem::GetCurrentWorker()
+{
+    return t_WorkerIndex;
+}
+
+int JobSystem::GetDefaultThreadCount()
+{
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 0 ? (int)cores : 1;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of worker threads sharing out jobs by work stealing. Every worker has
+// its own deque: it pushes and pops the jobs it submits at the back (newest
+// first, while their data is still in cache) and, once it runs dry, steals the
+// oldest job from the front of another worker's deque. Jobs submitted from other
+// threads are dealt out round-robin. Workers with nothing to do sleep.
+class JobSystem
+{
+    public:
+        typedef std::function<void()> Job;
+    private:
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+        std::vector<std::unique_ptr<Worker>> m_Workers;
+        std::vector<std::thread> m_Threads;
+
+        std::atomic<size_t> m_Queued;     // Submitted, not taken by any thread yet
+        std::atomic<size_t> m_Unfinished; // Submitted, not finished yet
+        std::atomic<size_t> m_NextWorker;
+        bool m_Stopping;
+        std::mutex m_SleepMutex;
+        std::condition_variable m_WakeUp;
+        std::condition_variable m_AllDone;
+
+        bool RunOne(int self);
+        void WorkerLoop(int index);
+    public:
+        // threadCount workers, 0 for one per core
+        explicit JobSystem(int threadCount = 0);
+        // Runs every job still queued, then joins the workers
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void Submit(Job job);
+        // Until every submitted job has finished, helping with them meanwhile. Not from inside a job
+        void Wait();
+
+        inline int GetThreadCount() const { return (int)m_Threads.size(); }
+        // Index of the worker running the calling thread, -1 outside every pool
+        static int GetCurrentWorker();
+        static int GetDefaultThreadCount();
+};
@@ -0,0 +1,72 @@
+#include <MappedFile.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+    : m_Data(nullptr), m_Size(0), m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr)
+{
+    m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE)
+        return;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+        return;
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_Mapping)
+        return;
+    m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_Data)
+        m_Size = (size_t)size.QuadPart;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+    if (m_File != INVALID_HANDLE_VALUE)
+        CloseHandle(m_File);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+    : m_Data(nullptr), m_Size(0)
+{
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return;
+    struct stat info;
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+    {
+        void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+        if (data != MAP_FAILED)
+        {
+            // Lookups jump all over the file, read-ahead would only evict useful pages
+            madvise(data, (size_t)info.st_size, MADV_RANDOM);
+            m_Data = (const unsigned char*)data;
+            m_Size = (size_t)info.st_size;
+        }
+    }
+    // The mapping keeps the file alive on its own
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+        munmap((void*)m_Data, m_Size);
+}
+
+#endif
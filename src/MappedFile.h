@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// A whole file mapped read-only into memory. Pages are read from disk the first
+// time they are touched and live in the OS page cache, so opening is instant
+// whatever the size, and every process mapping the same file shares one copy.
+class MappedFile
+{
+    private:
+        const unsigned char* m_Data;
+        size_t m_Size;
+#ifdef _WIN32
+        void* m_File;
+        void* m_Mapping;
+#endif
+    public:
+        // Check IsValid(): false when the file is missing, empty or can't be mapped
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        inline bool IsValid() const { return m_Data != nullptr; }
+        inline const unsigned char* GetData() const { return m_Data; }
+        inline size_t GetSize() const { return m_Size; }
+};
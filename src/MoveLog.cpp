@@ -0,0 +1,197 @@
+#include <MoveLog.h>
+#include <Debugger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+// "MLOG" and the format version, bumped whenever the encoding changes
+static const unsigned char s_Magic[4] = { 'M', 'L', 'O', 'G' };
+static const unsigned char s_Version = 1;
+
+// Blocks go to the writer once this full, or this old
+static const size_t s_BlockSize = 4096;
+static const std::chrono::seconds s_BlockAge(1);
+
+static void WriteVarint(std::vector<unsigned char>& bytes, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back((unsigned char)value);
+}
+
+MoveLogWriter::MoveLogWriter(const std::string& path, int cubeSize)
+    : m_File(path, std::ios::binary | std::ios::trunc), m_CubeSize(cubeSize), m_LastTimeMs(0),
+      m_Writing(false), m_Stopping(false)
+{
+    if (!m_File)
+    {
+        std::cout << "Could not create move log " << path << std::endl;
+        m_File.close();
+        return;
+    }
+    std::vector<unsigned char> header(s_Magic, s_Magic + sizeof(s_Magic));
+    header.push_back(s_Version);
+    WriteVarint(header, (uint64_t)cubeSize);
+    m_File.write((const char*)header.data(), (std::streamsize)header.size());
+    m_Block.reserve(s_BlockSize + 32);
+    m_Writer = std::thread(&MoveLogWriter::WriterLoop, this);
+}
+
+MoveLogWriter::~MoveLogWriter()
+{
+    if (!IsValid())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        HandOff();
+        m_Stopping = true;
+    }
+    m_BlockAdded.notify_all();
+    m_Writer.join();
+    m_File.flush();
+    if (!m_File)
+        std::cout << "Failed to write the move log" << std::endl;
+}
+
+void MoveLogWriter::Append(const LayerTurn& turn, double time)
+{
+    if (!IsValid())
+        return;
+    ASSERT(turn.axisIndex >= 0 && turn.axisIndex < 3 && turn.layer >= 0 && turn.layer < m_CubeSize);
+    const int64_t timeMs = std::max(m_LastTimeMs, (int64_t)std::llround(time * 1000.0));
+    // Only ever held briefly by the writer thread, never across a disk write
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Block.empty())
+        m_BlockStarted = std::chrono::steady_clock::now();
+    WriteVarint(m_Block, (uint64_t)(timeMs - m_LastTimeMs));
+    WriteVarint(m_Block, (uint64_t)(turn.layer * 3 + turn.axisIndex) * 8 + (unsigned)(turn.eighthTurns & 7));
+    m_LastTimeMs = timeMs;
+    if (m_Block.size() >= s_BlockSize)
+        HandOff();
+}
+
+void MoveLogWriter::HandOff()
+{
+    if (m_Block.empty())
+        return;
+    m_Blocks.push_back(std::move(m_Block));
+    m_Block.clear();
+    if (!m_FreeBlocks.empty())
+    {
+        m_Block.swap(m_FreeBlocks.back());
+        m_FreeBlocks.pop_back();
+    }
+    m_Block.reserve(s_BlockSize + 32);
+    m_BlockAdded.notify_one();
+}
+
+void MoveLogWriter::Flush()
+{
+    if (!IsValid())
+        return;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    HandOff();
+    m_BlockWritten.wait(lock, [this]() { return m_Blocks.empty() && !m_Writing; });
+}
+
+void MoveLogWriter::WriterLoop()
+{
+    std::deque<std::vector<unsigned char>> blocks;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        // Sleep until a block is handed off, or until the block being filled is a second old
+        const auto blockDue = m_Block.empty() ? std::chrono::steady_clock::now() + s_BlockAge : m_BlockStarted + s_BlockAge;
+        m_BlockAdded.wait_until(lock, blockDue, [this]() { return m_Stopping || !m_Blocks.empty(); });
+        if (!m_Block.empty() && std::chrono::steady_clock::now() >= m_BlockStarted + s_BlockAge)
+            HandOff();
+        if (m_Blocks.empty())
+        {
+            if (m_Stopping)
+                return;
+            continue;
+        }
+        // Everything handed off so far goes out in one write
+        blocks.swap(m_Blocks);
+        m_Writing = true;
+
+        // The disk is only touched with the lock released, Append never waits for it
+        lock.unlock();
+        for (const std::vector<unsigned char>& block : blocks)
+            m_File.write((const char*)block.data(), (std::streamsize)block.size());
+        m_File.flush();
+        lock.lock();
+        for (std::vector<unsigned char>& block : blocks)
+        {
+            block.clear();
+            m_FreeBlocks.push_back(std::move(block));
+        }
+        blocks.clear();
+        m_Writing = false;
+        m_BlockWritten.notify_all();
+    }
+}
+
+MoveLogReader::MoveLogReader(const std::string& path)
+    : m_Start(0), m_Position(0), m_TimeMs(0), m_CubeSize(0)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return;
+    m_Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    uint64_t cubeSize = 0;
+    if (m_Data.size() < sizeof(s_Magic) + 1 || !std::equal(s_Magic, s_Magic + sizeof(s_Magic), m_Data.begin())
+        || m_Data[sizeof(s_Magic)] != s_Version)
+        return;
+    m_Position = sizeof(s_Magic) + 1;
+    if (!ReadVarint(cubeSize) || cubeSize < 2 || cubeSize > 0xFFFF)
+        return;
+    m_Start = m_Position;
+    m_CubeSize = (int)cubeSize;
+}
+
+bool MoveLogReader::ReadVarint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && m_Position < m_Data.size(); shift += 7)
+    {
+        const unsigned char byte = m_Data[m_Position++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool MoveLogReader::Next(LoggedTurn& logged)
+{
+    if (!IsValid())
+        return false;
+    const size_t start = m_Position;
+    uint64_t delta, code;
+    if (!ReadVarint(delta) || !ReadVarint(code) || code / 8 >= (uint64_t)m_CubeSize * 3)
+    {
+        // Leave a damaged or cut off turn where it is
+        m_Position = start;
+        return false;
+    }
+    m_TimeMs += (int64_t)delta;
+    const int eighths = (int)(code & 7);
+    logged.turn.axisIndex = (int)(code / 8 % 3);
+    logged.turn.layer = (int)(code / 24);
+    logged.turn.eighthTurns = eighths > 4 ? eighths - 8 : eighths;
+    logged.time = m_TimeMs / 1000.0;
+    return true;
+}
+
+void MoveLogReader::Rewind()
+{
+    m_Position = m_Start;
+    m_TimeMs = 0;
+}
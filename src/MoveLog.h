@@ -0,0 +1,97 @@
+#pragma once
+
+#include <CubeGrid.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Move logs: every layer turn of a session with the time it started, in a
+// compact binary stream. After a short header (magic, version, cube size) each
+// turn is two LEB128 varints:
+// - milliseconds since the turn before (the first: since the log started)
+// - (layer * 3 + axis) * 8 + eighth turns mod 8
+// so a turn of a 3x3x3 cube takes 2 or 3 bytes. Angles come back in -3 to 4
+// eighth turns, the range queued turns are merged into.
+struct LoggedTurn
+{
+    LayerTurn turn;
+    double time; // Seconds since the log started
+};
+
+// Appends turns to a log file. Append only encodes into a block in memory and
+// hands full blocks to a writer thread, so the simulation never waits on the
+// disk. The writer thread also takes a block itself once its first turn is a
+// second old, so turns reach the file within about a second even when no more
+// come in.
+class MoveLogWriter
+{
+    private:
+        std::ofstream m_File;
+        int m_CubeSize;
+        int64_t m_LastTimeMs;
+        // The block being filled, shared with the writer thread like everything below
+        std::vector<unsigned char> m_Block;
+        std::chrono::steady_clock::time_point m_BlockStarted; // When the first turn of the block came in
+
+        std::thread m_Writer;
+        std::mutex m_Mutex;
+        std::condition_variable m_BlockAdded;
+        std::condition_variable m_BlockWritten;
+        std::deque<std::vector<unsigned char>> m_Blocks;
+        std::vector<std::vector<unsigned char>> m_FreeBlocks; // Written out, kept for their capacity
+        bool m_Writing;
+        bool m_Stopping;
+
+        // With m_Mutex held
+        void HandOff();
+        void WriterLoop();
+    public:
+        // Check IsValid(): false when the file can't be created
+        MoveLogWriter(const std::string& path, int cubeSize);
+        // Writes out everything appended
+        ~MoveLogWriter();
+        MoveLogWriter(const MoveLogWriter&) = delete;
+        MoveLogWriter& operator=(const MoveLogWriter&) = delete;
+
+        inline bool IsValid() const { return m_File.is_open(); }
+        inline int GetCubeSize() const { return m_CubeSize; }
+
+        // From one thread only, with time (seconds) never going backward
+        void Append(const LayerTurn& turn, double time);
+        // Until everything appended so far is on its way to the disk
+        void Flush();
+};
+
+// Reads a whole log into memory and decodes it one turn at a time
+class MoveLogReader
+{
+    private:
+        std::vector<unsigned char> m_Data;
+        size_t m_Start;    // First turn, past the header
+        size_t m_Position;
+        int64_t m_TimeMs;
+        int m_CubeSize;
+
+        bool ReadVarint(uint64_t& value);
+    public:
+        // Check IsValid(): false when the file is missing or its header is wrong
+        explicit MoveLogReader(const std::string& path);
+
+        inline bool IsValid() const { return m_CubeSize > 0; }
+        inline int GetCubeSize() const { return m_CubeSize; }
+        inline size_t GetByteSize() const { return m_Data.size(); }
+
+        // The next turn, false at the end of the log (or at a damaged turn, see IsAtEnd)
+        bool Next(LoggedTurn& logged);
+        inline bool IsAtEnd() const { return m_Position == m_Data.size(); }
+        // Back to the first turn
+        void Rewind();
+};
@@ -0,0 +1,47 @@
+#include <MoveQueue.h>
+#include <Debugger.h>
+
+MoveQueue::MoveQueue(size_t capacity)
+    : m_Head(0), m_Tail(0)
+{
+    size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+    m_Turns.resize(size);
+    m_Mask = size - 1;
+}
+
+bool MoveQueue::Push(const LayerTurn& turn)
+{
+    // Only the producer writes the tail, so a relaxed load sees its own last store
+    const size_t tail = m_Tail.load(std::memory_order_relaxed);
+    if (tail - m_Head.load(std::memory_order_acquire) == m_Turns.size())
+        return false;
+    m_Turns[tail & m_Mask] = turn;
+    // Publish the slot before the consumer can see the new tail
+    m_Tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool MoveQueue::Peek(LayerTurn& turn) const
+{
+    const size_t head = m_Head.load(std::memory_order_relaxed);
+    if (head == m_Tail.load(std::memory_order_acquire))
+        return false;
+    turn = m_Turns[head & m_Mask];
+    return true;
+}
+
+void MoveQueue::Pop()
+{
+    const size_t head = m_Head.load(std::memory_order_relaxed);
+    ASSERT(head != m_Tail.load(std::memory_order_acquire));
+    // Hand the slot back to the producer only once it has been read
+    m_Head.store(head + 1, std::memory_order_release);
+}
+
+size_t MoveQueue::GetSize() const
+{
+    const size_t head = m_Head.load(std::memory_order_acquire);
+    return m_Tail.load(std::memory_order_acquire) - head;
+}
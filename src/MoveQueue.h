@@ -0,0 +1,35 @@
+#pragma once
+
+#include <CubeGrid.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded single-producer / single-consumer ring of layer turns, carrying moves
+// from the input side (key callbacks, scripts) to the simulation without a lock.
+// Exactly one thread may push and exactly one may peek and pop; each index is
+// written only by its own side, and the two sit on separate cache lines so the
+// sides don't contend.
+class MoveQueue
+{
+    private:
+        std::vector<LayerTurn> m_Turns;
+        size_t m_Mask;
+        alignas(64) std::atomic<size_t> m_Head; // Next slot to read, written by the consumer
+        alignas(64) std::atomic<size_t> m_Tail; // Next slot to write, written by the producer
+    public:
+        // capacity is rounded up to a power of two
+        explicit MoveQueue(size_t capacity = 256);
+
+        // Producer: false when the queue is full, the turn is not queued
+        bool Push(const LayerTurn& turn);
+
+        // Consumer: the oldest turn without removing it, false when empty
+        bool Peek(LayerTurn& turn) const;
+        void Pop();
+
+        // Exact on the consumer side, a snapshot anywhere else
+        size_t GetSize() const;
+        inline bool IsEmpty() const { return GetSize() == 0; }
+};
@@ -0,0 +1,109 @@
+#include <MoveSequence.h>
+
+// How the merging sees each kind of move: the axis it turns about, its place among the
+// turns of that axis, and its angle in steps of a turn that takes STEPS to go all round
+struct LayerTurnTraits
+{
+    static const int STEPS = 8;
+    static int GetAxis(const LayerTurn& turn) { return turn.axisIndex; }
+    static int GetKey(const LayerTurn& turn) { return turn.layer; }
+    static int GetSteps(const LayerTurn& turn) { return turn.eighthTurns; }
+    static LayerTurn WithSteps(const LayerTurn& turn, int steps)
+    {
+        LayerTurn result = turn;
+        result.eighthTurns = steps;
+        return result;
+    }
+};
+
+// Turns with an id, merged like the turns themselves. The turn merged in comes with its id
+struct EntryTraits
+{
+    static const int STEPS = LayerTurnTraits::STEPS;
+    static int GetAxis(const MoveSequence::Entry& entry) { return entry.turn.axisIndex; }
+    static int GetKey(const MoveSequence::Entry& entry) { return entry.turn.layer; }
+    static int GetSteps(const MoveSequence::Entry& entry) { return entry.turn.eighthTurns; }
+    static MoveSequence::Entry WithSteps(const MoveSequence::Entry& entry, int steps)
+    {
+        return { LayerTurnTraits::WithSteps(entry.turn, steps), entry.id };
+    }
+};
+
+struct FaceMoveTraits
+{
+    static const int STEPS = 4;
+    static int GetAxis(int move) { return move / 3 % 3; }
+    static int GetKey(int move) { return move / 3; }
+    static int GetSteps(int move) { return move % 3 + 1; }
+    // Face moves only come clockwise: a quarter turn back is three forward
+    static int WithSteps(int move, int steps) { return move / 3 * 3 + (steps + FaceMoveTraits::STEPS) % FaceMoveTraits::STEPS - 1; }
+};
+
+// Appends move to turns, which is canonical, and keeps it canonical. The run of turns on move's
+// axis at the end of turns is short (one turn per layer at most), so this is constant time for
+// a fixed cube size
+template <typename Traits, typename Move, typename Sequence>
+static void Append(Sequence& turns, const Move& move)
+{
+    const int axis = Traits::GetAxis(move);
+    size_t runStart = turns.size();
+    while (runStart > 0 && Traits::GetAxis(turns[runStart - 1]) == axis)
+        runStart--;
+
+    size_t position = runStart;
+    while (position < turns.size() && Traits::GetKey(turns[position]) < Traits::GetKey(move))
+        position++;
+    if (position == turns.size() || Traits::GetKey(turns[position]) != Traits::GetKey(move))
+    {
+        // First turn of this layer in the run: kept as it came
+        if (Traits::GetSteps(move) % Traits::STEPS != 0)
+            turns.insert(turns.begin() + position, move);
+        return;
+    }
+
+    // Net angle, from a half turn back to a half turn forward
+    int steps = (Traits::GetSteps(turns[position]) + Traits::GetSteps(move)) % Traits::STEPS;
+    if (steps <= -Traits::STEPS / 2)
+        steps += Traits::STEPS;
+    else if (steps > Traits::STEPS / 2)
+        steps -= Traits::STEPS;
+    if (steps == 0)
+        turns.erase(turns.begin() + position);
+    else
+        turns[position] = Traits::WithSteps(move, steps);
+}
+
+void MoveSequence::Push(const LayerTurn& turn, uint64_t id)
+{
+    Append<EntryTraits>(m_Turns, Entry{ turn, id });
+}
+
+uint64_t MoveSequence::GetOldestId() const
+{
+    // Merging reorders the turns of a run, so the oldest needn't be the first
+    uint64_t oldest = 0;
+    for (const Entry& entry : m_Turns)
+    {
+        if (entry.id != 0 && (oldest == 0 || entry.id < oldest))
+            oldest = entry.id;
+    }
+    return oldest;
+}
+
+void MoveSequence::Canonicalize(std::vector<LayerTurn>& turns)
+{
+    std::vector<LayerTurn> result;
+    result.reserve(turns.size());
+    for (const LayerTurn& turn : turns)
+        Append<LayerTurnTraits>(result, turn);
+    turns.swap(result);
+}
+
+void MoveSequence::Canonicalize(std::vector<int>& moves)
+{
+    std::vector<int> result;
+    result.reserve(moves.size());
+    for (int move : moves)
+        Append<FaceMoveTraits>(result, move);
+    moves.swap(result);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <CubeGrid.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Move sequences in canonical form. Turns about the same axis commute, so a run
+// of them only matters through the net angle of each layer: in a canonical
+// sequence every run holds at most one turn per layer, sorted by layer, and no
+// turn by a whole revolution. R R R becomes R', R R' disappears, and L R becomes R L
+// (for face moves, where the order is by face).
+//
+// Turns are appended one at a time and merged into the run at the end, so the
+// sequence is canonical after every append and a run that cancels out lets the
+// run before it meet what comes next (R U U' R' ends up empty).
+//
+// A sequence is canonical exactly when CanFollow holds for every pair of
+// neighbors, which is what searches use to skip sequences that only repeat
+// shorter or reordered ones.
+//
+// Turns can be pushed with an id, to follow them through the merging: a turn
+// merged into one already there takes its place with its own id, so the earlier
+// turn's id is gone, as are the ids of turns that cancel out.
+class MoveSequence
+{
+    public:
+        struct Entry
+        {
+            LayerTurn turn;
+            uint64_t id;
+        };
+    private:
+        std::deque<Entry> m_Turns;
+    public:
+        // Append turn and merge it into the run at the end. id 0 is no id
+        void Push(const LayerTurn& turn, uint64_t id = 0);
+        inline const LayerTurn& Front() const { return m_Turns.front().turn; }
+        inline uint64_t GetFrontId() const { return m_Turns.front().id; }
+        // The smallest id left in the sequence, 0 when no turn in it has one
+        uint64_t GetOldestId() const;
+        inline void PopFront() { m_Turns.pop_front(); }
+        inline void Clear() { m_Turns.clear(); }
+        inline bool IsEmpty() const { return m_Turns.empty(); }
+        inline size_t GetSize() const { return m_Turns.size(); }
+
+        // Whether turn may come right after previous in a canonical sequence
+        static inline bool CanFollow(const LayerTurn& previous, const LayerTurn& turn)
+        {
+            return turn.axisIndex != previous.axisIndex || turn.layer > previous.layer;
+        }
+        static void Canonicalize(std::vector<LayerTurn>& turns);
+
+        // The same for face moves in CubeState numbering, previous being -1 at the start. Opposite faces
+        // share an axis and are ordered U before D, R before L, F before B
+        static inline bool CanFollow(int previous, int move)
+        {
+            if (previous < 0)
+                return true;
+            const int face = move / 3, previousFace = previous / 3;
+            return face % 3 != previousFace % 3 || face > previousFace;
+        }
+        static void Canonicalize(std::vector<int>& moves);
+};
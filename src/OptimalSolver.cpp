@@ -0,0 +1,575 @@
+#include <OptimalSolver.h>
+#include <CubeSymmetry.h>
+#include <Debugger.h>
+#include <MoveSequence.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Bumped whenever an index or the file layout changes, so stale databases are refused
+static const uint32_t PDB_MAGIC = 0x31424450; // "PDB1"
+static const uint32_t PDB_VERSION = 3;
+static const size_t PDB_HEADER_SIZE = 64;
+
+// God's number is 20
+static const int MAX_DEPTH = 20;
+// Searches hand out every sequence of this many moves to the threads as one work item
+static const int SPLIT_DEPTH = 3;
+// Nodes between two looks at the clock, a few tens of milliseconds' worth
+static const uint64_t TIMEOUT_CHECK_NODES = 1 << 12;
+
+static const unsigned char UNVISITED = 0xFF;
+// Every corner state, without symmetry reduction: 8! * 3^7
+static const uint64_t CORNER_STATE_COUNT = 88179840;
+// Every state of 8 edges: 12! / 4! placements, 2^8 flips
+static const uint64_t EDGE_STATE_COUNT = 5109350400ull;
+// An entry's neighbors: every move, and with symmetry reduction every entry symmetric to each
+static const int MAX_NEIGHBORS = CubeState::MOVE_COUNT * CubeSymmetry::UD_COUNT;
+
+struct PdbHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t table;
+    uint64_t entryCount;
+};
+
+// Where every piece is and how it is turned, rather than CubeState's piece in every slot:
+// each database follows a few pieces, wherever they go
+struct PieceState
+{
+    unsigned char cornerSlot[CubeState::CORNER_COUNT];
+    unsigned char cornerTwist[CubeState::CORNER_COUNT];
+    unsigned char edgeSlot[CubeState::EDGE_COUNT];
+    unsigned char edgeFlip[CubeState::EDGE_COUNT];
+
+    explicit PieceState(const CubeState& state)
+    {
+        for (int slot = 0; slot < CubeState::CORNER_COUNT; slot++)
+        {
+            cornerSlot[state.cp[slot]] = (unsigned char)slot;
+            cornerTwist[state.cp[slot]] = state.co[slot];
+        }
+        for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+        {
+            edgeSlot[state.ep[slot]] = (unsigned char)slot;
+            edgeFlip[state.ep[slot]] = state.eo[slot];
+        }
+    }
+    PieceState() = default;
+};
+
+// [move][slot]: the slot a move takes the piece in slot to, and the twist or flip it adds on the way
+struct MoveTransitions
+{
+    unsigned char cornerTo[CubeState::MOVE_COUNT][CubeState::CORNER_COUNT];
+    unsigned char cornerTwist[CubeState::MOVE_COUNT][CubeState::CORNER_COUNT];
+    unsigned char edgeTo[CubeState::MOVE_COUNT][CubeState::EDGE_COUNT];
+    unsigned char edgeFlip[CubeState::MOVE_COUNT][CubeState::EDGE_COUNT];
+
+    MoveTransitions()
+    {
+        // Read off each move applied to the solved cube
+        for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+        {
+            CubeState turned;
+            turned.ApplyMove(move);
+            for (int to = 0; to < CubeState::CORNER_COUNT; to++)
+            {
+                cornerTo[move][turned.cp[to]] = (unsigned char)to;
+                cornerTwist[move][turned.cp[to]] = turned.co[to];
+            }
+            for (int to = 0; to < CubeState::EDGE_COUNT; to++)
+            {
+                edgeTo[move][turned.ep[to]] = (unsigned char)to;
+                edgeFlip[move][turned.ep[to]] = turned.eo[to];
+            }
+        }
+    }
+
+    inline void ApplyCorners(int move, const unsigned char* slots, const unsigned char* twists,
+                             unsigned char* newSlots, unsigned char* newTwists, int count) const
+    {
+        static const unsigned char s_Mod3[5] = { 0, 1, 2, 0, 1 };
+        for (int i = 0; i < count; i++)
+        {
+            newSlots[i] = cornerTo[move][slots[i]];
+            newTwists[i] = s_Mod3[twists[i] + cornerTwist[move][slots[i]]];
+        }
+    }
+
+    inline void ApplyEdges(int move, const unsigned char* slots, const unsigned char* flips,
+                           unsigned char* newSlots, unsigned char* newFlips, int count) const
+    {
+        for (int i = 0; i < count; i++)
+        {
+            newSlots[i] = edgeTo[move][slots[i]];
+            newFlips[i] = flips[i] ^ edgeFlip[move][slots[i]];
+        }
+    }
+
+    inline void Apply(int move, const PieceState& state, PieceState& result) const
+    {
+        ApplyCorners(move, state.cornerSlot, state.cornerTwist, result.cornerSlot, result.cornerTwist, CubeState::CORNER_COUNT);
+        ApplyEdges(move, state.edgeSlot, state.edgeFlip, result.edgeSlot, result.edgeFlip, CubeState::EDGE_COUNT);
+    }
+};
+
+static const MoveTransitions& GetTransitions()
+{
+    static const MoveTransitions transitions;
+    return transitions;
+}
+
+// Lehmer code of the corner placement, then the twists of the first 7 corners (the last one follows from them)
+static uint64_t GetCornerIndex(const unsigned char* slots, const unsigned char* twists)
+{
+    return (uint64_t)CornerSymmetry::RankPlacement(slots) * CornerSymmetry::TWIST_COUNT + CornerSymmetry::RankTwist(twists);
+}
+
+// The corners seen from the pieces are the inverse cube's corners seen from its slots, with every
+// twist turned back, and a cube is as far from solved as its inverse
+static int GetCornerClassIndex(const CornerSymmetry& symmetry, const unsigned char* slots, const unsigned char* twists)
+{
+    static const unsigned char s_Inverse[3] = { 0, 2, 1 };
+    int twist = 0;
+    for (int i = 0; i < CubeState::CORNER_COUNT - 1; i++)
+        twist = twist * 3 + s_Inverse[twists[i]];
+    return symmetry.GetEntry(CornerSymmetry::RankPlacement(slots), twist);
+}
+
+static void GetCornersFromIndex(uint64_t index, unsigned char* slots, unsigned char* twists)
+{
+    CornerSymmetry::UnrankPlacement((int)(index / CornerSymmetry::TWIST_COUNT), slots);
+    CornerSymmetry::UnrankTwist((int)(index % CornerSymmetry::TWIST_COUNT), twists);
+}
+
+static int GetThreadCount(int requested)
+{
+    if (requested > 0)
+        return requested;
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 0 ? (int)cores : 1;
+}
+
+// Runs work on threadCount threads, this one included, and waits for all of them
+template <typename Work>
+static void RunThreads(int threadCount, const Work& work)
+{
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++)
+        threads.emplace_back(work);
+    work();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+std::string OptimalSolver::GetTablePath(const std::string& directory, Table table)
+{
+    static const char* s_Names[TABLE_COUNT] = { "corners.pdb", "edges.pdb" };
+    return (std::filesystem::path(directory) / s_Names[table]).string();
+}
+
+uint64_t OptimalSolver::GetEntryCount(Table table, bool symmetryReduced)
+{
+    if (table == CORNERS)
+        return symmetryReduced ? CornerSymmetry::ENTRY_COUNT : CORNER_STATE_COUNT;
+    return symmetryReduced ? EdgeSymmetry::ENTRY_COUNT : EDGE_STATE_COUNT;
+}
+
+OptimalSolver::OptimalSolver(const std::string& directory)
+    : m_Tables()
+{
+    for (int table = 0; table < TABLE_COUNT; table++)
+    {
+        std::unique_ptr<MappedFile> file(new MappedFile(GetTablePath(directory, (Table)table)));
+        if (!file->IsValid() || file->GetSize() < PDB_HEADER_SIZE)
+            return;
+        PdbHeader header;
+        std::memcpy(&header, file->GetData(), sizeof(header));
+        if (header.magic != PDB_MAGIC || header.version != PDB_VERSION || header.table != (uint32_t)table)
+            return;
+        const uint64_t entryCount = GetEntryCount((Table)table);
+        if (header.entryCount != entryCount || file->GetSize() < PDB_HEADER_SIZE + (entryCount + 1) / 2)
+            return;
+        m_Files[table] = std::move(file);
+    }
+
+    for (int table = 0; table < TABLE_COUNT; table++)
+        m_Tables[table] = m_Files[table]->GetData() + PDB_HEADER_SIZE;
+}
+
+// A work item: the cube after SPLIT_DEPTH moves
+struct SearchPrefix
+{
+    PieceState state;
+    int moves[SPLIT_DEPTH];
+};
+
+struct OptimalSolver::Search
+{
+    const OptimalSolver& solver;
+    const MoveTransitions& transitions;
+    const CornerSymmetry& cornerSymmetry;
+    const EdgeSymmetry& edgeSymmetry;
+    std::atomic<bool>& stop;
+    std::atomic<bool>& timedOut;
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+
+    int bound = 0;
+    int moves[MAX_DEPTH];
+    uint64_t nodes = 0;
+
+    // One deadline for the whole solve, shared by the searches of every bound and thread
+    Search(const OptimalSolver& solver, std::atomic<bool>& stop, std::atomic<bool>& timedOut, bool hasDeadline,
+           std::chrono::steady_clock::time_point deadline)
+        : solver(solver), transitions(GetTransitions()), cornerSymmetry(CornerSymmetry::Get()), edgeSymmetry(EdgeSymmetry::Get()), stop(stop), timedOut(timedOut),
+          hasDeadline(hasDeadline), deadline(deadline)
+    {
+    }
+
+    // 0 only on the solved cube: the corners and the edges around the three axes, which overlap, cover every piece.
+    // Stops at the first lookup over limit, since the search only needs to know the state is out of reach
+    int Estimate(const PieceState& state, int limit = MAX_DEPTH) const
+    {
+        int estimate = GetDistance(solver.m_Tables[CORNERS], GetCornerClassIndex(cornerSymmetry, state.cornerSlot, state.cornerTwist));
+        for (int axis = 0; axis < EdgeSymmetry::AXIS_COUNT && estimate <= limit; axis++)
+            estimate = std::max(estimate, GetDistance(solver.m_Tables[EDGES], edgeSymmetry.GetEntry(state.edgeSlot, state.edgeFlip, axis)));
+        return estimate;
+    }
+
+    // Depth-first below state, reached with depth moves, for a solution of exactly bound moves
+    bool Expand(const PieceState& state, int depth, int previous)
+    {
+        if (++nodes % TIMEOUT_CHECK_NODES == 0 && hasDeadline && std::chrono::steady_clock::now() > deadline)
+        {
+            timedOut = true;
+            stop = true;
+        }
+        if (stop.load(std::memory_order_relaxed))
+            return false;
+
+        PieceState next;
+        for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+        {
+            if (!MoveSequence::CanFollow(previous, move))
+                continue;
+            transitions.Apply(move, state, next);
+            const int estimate = Estimate(next, bound - depth - 1);
+            if (depth + 1 + estimate > bound)
+                continue;
+            moves[depth] = move;
+            // Every shorter bound has been searched already, so this is at exactly bound moves
+            if (estimate == 0 || Expand(next, depth + 1, move))
+                return true;
+        }
+        return false;
+    }
+
+    // Every sequence of SPLIT_DEPTH moves that could still lead to a solution of bound moves
+    void CollectPrefixes(const PieceState& state, int depth, SearchPrefix& prefix, std::vector<SearchPrefix>& prefixes) const
+    {
+        if (depth == SPLIT_DEPTH)
+        {
+            prefix.state = state;
+            prefixes.push_back(prefix);
+            return;
+        }
+        PieceState next;
+        for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+        {
+            if (!MoveSequence::CanFollow(depth > 0 ? prefix.moves[depth - 1] : -1, move))
+                continue;
+            transitions.Apply(move, state, next);
+            if (depth + 1 + Estimate(next, bound - depth - 1) > bound)
+                continue;
+            prefix.moves[depth] = move;
+            CollectPrefixes(next, depth + 1, prefix, prefixes);
+        }
+    }
+};
+
+int OptimalSolver::GetDistanceBound(const CubeState& state) const
+{
+    ASSERT(IsLoaded());
+    std::atomic<bool> stop(false), timedOut(false);
+    return Search(*this, stop, timedOut, false, std::chrono::steady_clock::time_point()).Estimate(PieceState(state));
+}
+
+bool OptimalSolver::Solve(const CubeState& state, std::vector<int>& moves, int threadCount, double timeoutMs) const
+{
+    moves.clear();
+    if (!IsLoaded() || !state.IsValid())
+        return false;
+    threadCount = GetThreadCount(threadCount);
+
+    const PieceState start(state);
+    std::atomic<bool> stop(false), timedOut(false);
+    const bool hasDeadline = timeoutMs > 0.0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(timeoutMs * 1000.0));
+    Search root(*this, stop, timedOut, hasDeadline, deadline);
+    const int startEstimate = root.Estimate(start);
+    if (startEstimate == 0)
+        return true;
+
+    // Iterative deepening: every bound is searched to the end before the next one, so the first solution is optimal
+    for (int bound = startEstimate; bound <= MAX_DEPTH; bound++)
+    {
+        if (bound <= SPLIT_DEPTH)
+        {
+            // Too shallow to be worth splitting
+            root.bound = bound;
+            if (root.Expand(start, 0, -1))
+            {
+                moves.assign(root.moves, root.moves + bound);
+                return true;
+            }
+            continue;
+        }
+
+        std::vector<SearchPrefix> prefixes;
+        SearchPrefix prefix;
+        root.bound = bound;
+        root.CollectPrefixes(start, 0, prefix, prefixes);
+
+        std::atomic<size_t> nextPrefix(0);
+        std::mutex solutionMutex;
+        RunThreads(threadCount, [&]()
+        {
+            Search search(*this, stop, timedOut, hasDeadline, deadline);
+            search.bound = bound;
+            for (size_t i = nextPrefix++; i < prefixes.size() && !stop; i = nextPrefix++)
+            {
+                const SearchPrefix& item = prefixes[i];
+                std::copy(item.moves, item.moves + SPLIT_DEPTH, search.moves);
+                if (search.Expand(item.state, SPLIT_DEPTH, item.moves[SPLIT_DEPTH - 1]))
+                {
+                    std::lock_guard<std::mutex> lock(solutionMutex);
+                    if (moves.empty())
+                        moves.assign(search.moves, search.moves + bound);
+                    stop = true;
+                }
+            }
+        });
+        if (!moves.empty())
+            return true;
+        if (timedOut)
+            return false;
+    }
+    return false;
+}
+
+// Exact distance of every entry from the solved one, one breadth-first level at a time.
+// expand fills in the entries one move away from an entry (at most MAX_NEIGHBORS) and
+// returns how many there are. Early levels go forward from
+// the entries just reached; once those outnumber the entries left, it is cheaper to go
+// backward from each entry left and look for a neighbor on the last level. Going backward
+// every entry is checked on its own, so expand is told it can leave out the entries
+// symmetric to a neighbor.
+// Returns the distances packed 4 bits per entry
+template <typename Expand>
+static std::vector<unsigned char> BuildDistances(const char* name, uint64_t entryCount, uint64_t solvedIndex,
+                                                 int threadCount, const Expand& expand)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::cout << "Building " << name << " (" << entryCount << " entries, " << threadCount << " threads)" << std::endl;
+
+    std::vector<std::atomic<unsigned char>> distances(entryCount);
+    for (std::atomic<unsigned char>& distance : distances)
+        distance.store(UNVISITED, std::memory_order_relaxed);
+    distances[solvedIndex].store(0, std::memory_order_relaxed);
+
+    static const uint64_t CHUNK_SIZE = 1 << 16;
+    uint64_t reached = 1, lastLevel = 1;
+    for (int depth = 0; reached < entryCount; depth++)
+    {
+        const bool backward = lastLevel > entryCount - reached;
+        std::atomic<uint64_t> nextChunk(0), found(0);
+        RunThreads(threadCount, [&]()
+        {
+            uint64_t neighbors[MAX_NEIGHBORS];
+            uint64_t count = 0;
+            for (uint64_t begin = nextChunk.fetch_add(CHUNK_SIZE); begin < entryCount; begin = nextChunk.fetch_add(CHUNK_SIZE))
+            {
+                const uint64_t end = std::min(begin + CHUNK_SIZE, entryCount);
+                for (uint64_t index = begin; index < end; index++)
+                {
+                    const unsigned char distance = distances[index].load(std::memory_order_relaxed);
+                    if (backward)
+                    {
+                        if (distance != UNVISITED)
+                            continue;
+                        const int neighborCount = expand(index, neighbors, backward);
+                        for (int i = 0; i < neighborCount; i++)
+                        {
+                            if (distances[neighbors[i]].load(std::memory_order_relaxed) == depth)
+                            {
+                                // Only this thread writes this entry
+                                distances[index].store((unsigned char)(depth + 1), std::memory_order_relaxed);
+                                count++;
+                                break;
+                            }
+                        }
+                    }
+                    else
+                    {
+                        if (distance != depth)
+                            continue;
+                        const int neighborCount = expand(index, neighbors, backward);
+                        for (int i = 0; i < neighborCount; i++)
+                        {
+                            unsigned char unvisited = UNVISITED;
+                            if (distances[neighbors[i]].load(std::memory_order_relaxed) == UNVISITED &&
+                                distances[neighbors[i]].compare_exchange_strong(unvisited, (unsigned char)(depth + 1), std::memory_order_relaxed))
+                                count++;
+                        }
+                    }
+                }
+            }
+            found += count;
+        });
+        ASSERT(found > 0);
+        lastLevel = found;
+        reached += found;
+        std::cout << "  " << depth + 1 << " moves: " << found << (backward ? " (backward)" : "") << std::endl;
+    }
+
+    std::vector<unsigned char> packed((entryCount + 1) / 2, 0);
+    for (uint64_t index = 0; index < entryCount; index++)
+    {
+        const unsigned char distance = std::min<unsigned char>(distances[index].load(std::memory_order_relaxed), 15);
+        packed[index >> 1] |= (unsigned char)(distance << ((index & 1) * 4));
+    }
+    std::cout << "  done in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+    return packed;
+}
+
+static bool WriteTable(const std::string& path, OptimalSolver::Table table, uint64_t entryCount, const std::vector<unsigned char>& packed)
+{
+    unsigned char header[PDB_HEADER_SIZE] = {};
+    const PdbHeader fields = { PDB_MAGIC, PDB_VERSION, (uint32_t)table, entryCount };
+    std::memcpy(header, &fields, sizeof(fields));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)packed.data(), (std::streamsize)packed.size());
+    if (!file)
+    {
+        std::cout << "Could not write " << path << std::endl;
+        return false;
+    }
+    std::cout << "  written to " << path << std::endl;
+    return true;
+}
+
+std::vector<unsigned char> OptimalSolver::BuildCornerTable(bool symmetryReduced, int threadCount)
+{
+    threadCount = GetThreadCount(threadCount);
+    const MoveTransitions& transitions = GetTransitions();
+    const CornerSymmetry& symmetry = CornerSymmetry::Get();
+    const PieceState solved{ CubeState() };
+    if (!symmetryReduced)
+    {
+        return BuildDistances("corners", CORNER_STATE_COUNT, GetCornerIndex(solved.cornerSlot, solved.cornerTwist), threadCount,
+            [&](uint64_t index, uint64_t* neighbors, bool)
+            {
+                unsigned char slots[CubeState::CORNER_COUNT], twists[CubeState::CORNER_COUNT];
+                unsigned char newSlots[CubeState::CORNER_COUNT], newTwists[CubeState::CORNER_COUNT];
+                GetCornersFromIndex(index, slots, twists);
+                for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+                {
+                    transitions.ApplyCorners(move, slots, twists, newSlots, newTwists, CubeState::CORNER_COUNT);
+                    neighbors[move] = GetCornerIndex(newSlots, newTwists);
+                }
+                return CubeState::MOVE_COUNT;
+            });
+    }
+
+    // An entry stands for its representative's corners, seen as the pieces of the inverse cube like every
+    // lookup does. A neighbor reached through a different symmetry than the one the lookup takes would be
+    // stored under another entry of the same class, so going forward every symmetric entry is reached along with it
+    return BuildDistances("corners (symmetry classes)", CornerSymmetry::ENTRY_COUNT,
+        GetCornerClassIndex(symmetry, solved.cornerSlot, solved.cornerTwist), threadCount,
+        [&](uint64_t index, uint64_t* neighbors, bool backward)
+        {
+            static const unsigned char s_Inverse[3] = { 0, 2, 1 };
+            unsigned char slots[CubeState::CORNER_COUNT], twists[CubeState::CORNER_COUNT];
+            unsigned char newSlots[CubeState::CORNER_COUNT], newTwists[CubeState::CORNER_COUNT];
+            CornerSymmetry::UnrankPlacement(symmetry.GetPlacement((int)index), slots);
+            CornerSymmetry::UnrankTwist(symmetry.GetTwist((int)index), twists);
+            for (unsigned char& twist : twists)
+                twist = s_Inverse[twist];
+            int count = 0;
+            for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+            {
+                transitions.ApplyCorners(move, slots, twists, newSlots, newTwists, CubeState::CORNER_COUNT);
+                const int entry = GetCornerClassIndex(symmetry, newSlots, newTwists);
+                if (backward)
+                {
+                    neighbors[count++] = (uint64_t)entry;
+                    continue;
+                }
+                int entries[CubeSymmetry::UD_COUNT];
+                const int entryCount = symmetry.GetSymmetricEntries(entry, entries);
+                for (int i = 0; i < entryCount; i++)
+                    neighbors[count++] = (uint64_t)entries[i];
+            }
+            return count;
+        });
+}
+
+uint64_t OptimalSolver::GetCornerEntry(const CubeState& state, bool symmetryReduced)
+{
+    const PieceState pieces(state);
+    if (symmetryReduced)
+        return GetCornerClassIndex(CornerSymmetry::Get(), pieces.cornerSlot, pieces.cornerTwist);
+    return GetCornerIndex(pieces.cornerSlot, pieces.cornerTwist);
+}
+
+bool OptimalSolver::GenerateDatabases(const std::string& directory, int threadCount)
+{
+    threadCount = GetThreadCount(threadCount);
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (!WriteTable(GetTablePath(directory, CORNERS), CORNERS, GetEntryCount(CORNERS), BuildCornerTable(true, threadCount)))
+        return false;
+
+    // As with the corners, a neighbor comes with every entry symmetric to it
+    const MoveTransitions& transitions = GetTransitions();
+    const EdgeSymmetry& symmetry = EdgeSymmetry::Get();
+    const PieceState solved{ CubeState() };
+    const std::vector<unsigned char> packed = BuildDistances("edges (symmetry classes)", GetEntryCount(EDGES),
+        symmetry.GetEntry(solved.edgeSlot, solved.edgeFlip), threadCount,
+        [&](uint64_t index, uint64_t* neighbors, bool backward)
+        {
+            unsigned char slots[EdgeSymmetry::PIECE_COUNT], flips[EdgeSymmetry::PIECE_COUNT];
+            unsigned char newSlots[EdgeSymmetry::PIECE_COUNT], newFlips[EdgeSymmetry::PIECE_COUNT];
+            symmetry.GetState((int)index, slots, flips);
+            int count = 0;
+            for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+            {
+                transitions.ApplyEdges(move, slots, flips, newSlots, newFlips, EdgeSymmetry::PIECE_COUNT);
+                const int entry = symmetry.GetEntry(newSlots, newFlips);
+                if (backward)
+                {
+                    neighbors[count++] = (uint64_t)entry;
+                    continue;
+                }
+                int entries[CubeSymmetry::UD_COUNT];
+                const int entryCount = symmetry.GetSymmetricEntries(entry, entries);
+                for (int i = 0; i < entryCount; i++)
+                    neighbors[count++] = (uint64_t)entries[i];
+            }
+            return count;
+        });
+    return WriteTable(GetTablePath(directory, EDGES), EDGES, GetEntryCount(EDGES), packed);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <CubeState.h>
+#include <MappedFile.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Optimal 3x3x3 solver: IDA* (Korf) bounded by two pattern databases, each the
+// exact distance to solved of a part of the cube:
+// - all 8 corners, placement and twist: one entry per class of states the 16 U-D
+//   symmetries map onto each other (CornerSymmetry), 6 million rather than 88 million
+// - the 8 U and D layer edges, placement and flip, likewise up to the 16 U-D
+//   symmetries (EdgeSymmetry), 464 million entries rather than 5.1 billion
+// Seen through a rotation, the R and L layer edges and the F and B layer edges
+// are the U and D layer edges again, so every state gets three edge lookups out
+// of the one table. Distances are stored 4 bits each, so the two files take
+// about 235 MB together, 3 MB of it the corners, which stay in cache.
+//
+// The databases are generated once by tools/pdb_gen (make pdb) and memory-mapped
+// read-only here: loading is instant, only the pages a search touches are ever read
+// from disk, and processes solving at the same time share the OS page cache.
+// Searches split the first few moves across threads.
+class OptimalSolver
+{
+    public:
+        enum Table { CORNERS, EDGES, TABLE_COUNT };
+    private:
+        std::unique_ptr<MappedFile> m_Files[TABLE_COUNT];
+        const unsigned char* m_Tables[TABLE_COUNT]; // 4 bits per entry, low half first
+
+        struct Search;
+    public:
+        // Maps the databases written to directory by GenerateDatabases. Check IsLoaded()
+        explicit OptimalSolver(const std::string& directory = "pdb");
+
+        inline bool IsLoaded() const { return m_Tables[CORNERS] != nullptr; }
+
+        // A shortest move sequence (CubeState numbering) that solves state, using threadCount threads
+        // (0 for one per core). False for an invalid state, or when timeoutMs (if not 0) ran out first
+        bool Solve(const CubeState& state, std::vector<int>& moves, int threadCount = 0, double timeoutMs = 0.0) const;
+
+        // Lower bound on the moves left to solve state, from the databases
+        int GetDistanceBound(const CubeState& state) const;
+
+        // Breadth-first search over each part of the cube, writing the two database files into
+        // directory. The edges take a few minutes on a multi-core machine
+        static bool GenerateDatabases(const std::string& directory, int threadCount = 0);
+
+        static std::string GetTablePath(const std::string& directory, Table table);
+        // Entries of a table, or of the same table without symmetry reduction (one per state of its pieces)
+        static uint64_t GetEntryCount(Table table, bool symmetryReduced = true);
+
+        // The corner database alone, in memory: over the symmetry classes as in the file, or (symmetryReduced
+        // false) over all 88 million corner states. GetCornerEntry is where a state's distance sits in it
+        static std::vector<unsigned char> BuildCornerTable(bool symmetryReduced, int threadCount = 0);
+        static uint64_t GetCornerEntry(const CubeState& state, bool symmetryReduced);
+        static inline int GetDistance(const unsigned char* table, uint64_t entry)
+        {
+            return (table[entry >> 1] >> ((entry & 1) * 4)) & 15;
+        }
+};
@@ -0,0 +1,157 @@
+#include <Profiler.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+bool Profiler::s_Enabled = false;
+std::vector<Profiler::Event> Profiler::s_Events;
+std::atomic<uint64_t> Profiler::s_WriteIndex(0);
+
+std::vector<Profiler::GpuQuery> Profiler::s_GpuQueries;
+unsigned int Profiler::s_NextGpuQuery = 0;
+int64_t Profiler::s_GpuToCpuOffset = 0;
+uint64_t Profiler::s_DroppedGpuScopes = 0;
+
+static std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+uint64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+}
+
+uint32_t Profiler::GetThreadID()
+{
+    // Small stable numbers read better in the trace viewer than native thread ids
+    static std::atomic<uint32_t> s_NextThread(s_GpuThread + 1);
+    thread_local uint32_t thread = s_NextThread++;
+    return thread;
+}
+
+void Profiler::Init(unsigned int eventCapacity, unsigned int gpuQueryCount)
+{
+    // Round up to a power of two so a slot is just a mask of the write index
+    unsigned int capacity = 1;
+    while (capacity < eventCapacity)
+        capacity <<= 1;
+    s_Events = std::vector<Event>(capacity);
+
+    s_GpuQueries.resize(gpuQueryCount);
+    for (GpuQuery& query : s_GpuQueries)
+    {
+        GLCall(glGenQueries(2, query.queries));
+        query.pending = false;
+    }
+
+    // One synchronous read of the GPU clock to line its timestamps up with the CPU ones
+    int64_t gpuNow = 0;
+    GLCall(glGetInteger64v(GL_TIMESTAMP, &gpuNow));
+    s_GpuToCpuOffset = (int64_t)Now() - gpuNow;
+    s_Enabled = true;
+}
+
+void Profiler::Shutdown()
+{
+    s_Enabled = false;
+    for (GpuQuery& query : s_GpuQueries)
+    {
+        GLCall(glDeleteQueries(2, query.queries));
+    }
+    s_GpuQueries.clear();
+}
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end, uint32_t thread)
+{
+    // Claiming a slot is the only shared write, any thread can record without a lock
+    const uint64_t index = s_WriteIndex.fetch_add(1, std::memory_order_relaxed);
+    Event& event = s_Events[index & (s_Events.size() - 1)];
+    event.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.start = start;
+    event.duration = end > start ? end - start : 0;
+    event.thread = thread;
+    event.sequence.store(index * 2 + 2, std::memory_order_release);
+}
+
+void Profiler::RecordCpu(const char* name, uint64_t start, uint64_t end)
+{
+    Record(name, start, end, GetThreadID());
+}
+
+int Profiler::BeginGpu(const char* name)
+{
+    GpuQuery& query = s_GpuQueries[s_NextGpuQuery];
+    if (query.pending)
+    {
+        // Results are too far behind to reuse the pair, lose this scope instead of waiting
+        s_DroppedGpuScopes++;
+        return -1;
+    }
+    query.name = name;
+    query.pending = true;
+    GLCall(glQueryCounter(query.queries[0], GL_TIMESTAMP));
+
+    const int index = s_NextGpuQuery;
+    s_NextGpuQuery = (s_NextGpuQuery + 1) % s_GpuQueries.size();
+    return index;
+}
+
+void Profiler::EndGpu(int query)
+{
+    GLCall(glQueryCounter(s_GpuQueries[query].queries[1], GL_TIMESTAMP));
+}
+
+void Profiler::EndFrame()
+{
+    if (!s_Enabled)
+        return;
+
+    for (GpuQuery& query : s_GpuQueries)
+    {
+        if (!query.pending)
+            continue;
+
+        // The end query lands after the begin one, so it alone says whether the pair is done
+        unsigned int available = 0;
+        GLCall(glGetQueryObjectuiv(query.queries[1], GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            continue;
+
+        uint64_t begin = 0, end = 0;
+        GLCall(glGetQueryObjectui64v(query.queries[0], GL_QUERY_RESULT, &begin));
+        GLCall(glGetQueryObjectui64v(query.queries[1], GL_QUERY_RESULT, &end));
+        Record(query.name, begin + s_GpuToCpuOffset, end + s_GpuToCpuOffset, s_GpuThread);
+        query.pending = false;
+    }
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filepath)
+{
+    std::ofstream stream(filepath);
+    if (!stream)
+        return false;
+
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << s_GpuThread << ",\"args\":{\"name\":\"GPU\"}}";
+
+    // Only the newest events survive once the ring has wrapped
+    const uint64_t written = s_WriteIndex.load(std::memory_order_acquire);
+    const uint64_t first = written > s_Events.size() ? written - s_Events.size() : 0;
+    for (uint64_t index = first; index < written; index++)
+    {
+        const Event& event = s_Events[index & (s_Events.size() - 1)];
+        if (event.sequence.load(std::memory_order_acquire) != index * 2 + 2)
+            continue;
+
+        // Trace event times are in microseconds
+        stream << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+            << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0 << "}";
+    }
+    stream << "\n]}\n";
+
+    if (s_DroppedGpuScopes > 0)
+        std::cout << "Profiler: " << s_DroppedGpuScopes << " GPU scopes dropped, the query pool was exhausted" << std::endl;
+    return (bool)stream;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame profiler: CPU scopes and GPU timer queries go into a lock-free ring of
+// events that can be written out as Chrome trace JSON (chrome://tracing, Perfetto).
+// Everything is a no-op until Init is called.
+class Profiler
+{
+    private:
+        struct Event
+        {
+            std::atomic<uint64_t> sequence;  // Odd while the slot is written, even once done
+            const char* name;
+            uint64_t start;                  // Nanoseconds since Init
+            uint64_t duration;
+            uint32_t thread;
+        };
+
+        struct GpuQuery
+        {
+            unsigned int queries[2];
+            const char* name;
+            bool pending;
+        };
+
+        static const uint32_t s_GpuThread = 0;
+
+        static bool s_Enabled;
+        static std::vector<Event> s_Events;
+        static std::atomic<uint64_t> s_WriteIndex;
+
+        static std::vector<GpuQuery> s_GpuQueries;
+        static unsigned int s_NextGpuQuery;
+        static int64_t s_GpuToCpuOffset;
+        static uint64_t s_DroppedGpuScopes;
+
+        static uint32_t GetThreadID();
+        static void Record(const char* name, uint64_t start, uint64_t end, uint32_t thread);
+    public:
+        // Start recording, needs a current GL context for the GPU clock
+        static void Init(unsigned int eventCapacity = 1 << 16, unsigned int gpuQueryCount = 64);
+        // Free the GL queries, call while the context is still current
+        static void Shutdown();
+
+        inline static bool IsEnabled() { return s_Enabled; }
+        static uint64_t Now();
+
+        static void RecordCpu(const char* name, uint64_t start, uint64_t end);
+
+        // Timestamp query pair around GPU work, returns -1 when the pool is exhausted
+        static int BeginGpu(const char* name);
+        static void EndGpu(int query);
+
+        // Turn GPU queries whose results have arrived into events, never waits. Call once per frame
+        static void EndFrame();
+
+        static bool WriteChromeTrace(const std::string& filepath);
+};
+
+// Records the enclosing block as a CPU event
+class ProfileScope
+{
+    private:
+        const char* m_Name;
+        uint64_t m_Start;
+    public:
+        ProfileScope(const char* name)
+            : m_Name(name), m_Start(Profiler::IsEnabled() ? Profiler::Now() : 0) {}
+        ~ProfileScope()
+        {
+            if (Profiler::IsEnabled())
+                Profiler::RecordCpu(m_Name, m_Start, Profiler::Now());
+        }
+};
+
+// Records the GPU time of the commands issued in the enclosing block
+class GpuProfileScope
+{
+    private:
+        int m_Query;
+    public:
+        GpuProfileScope(const char* name)
+            : m_Query(Profiler::IsEnabled() ? Profiler::BeginGpu(name) : -1) {}
+        ~GpuProfileScope()
+        {
+            if (m_Query >= 0)
+                Profiler::EndGpu(m_Query);
+        }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define GPU_PROFILE_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
@@ -0,0 +1,72 @@
+#include <RenderCommands.h>
+
+RenderCommandBuffer::RenderCommandBuffer()
+    : m_MatrixCount(0), m_StringCount(0), m_Frame(0), m_TurnsSettled(0)
+{
+}
+
+void RenderCommandBuffer::Reset(unsigned long long frame)
+{
+    m_Commands.clear();
+    m_MatrixCount = 0;
+    m_StringCount = 0;
+    m_Ints.clear();
+    m_Constants.clear();
+    m_Frame = frame;
+    m_TurnsSettled = 0;
+}
+
+RenderCommand& RenderCommandBuffer::Push(RenderCommandType type)
+{
+    m_Commands.push_back(RenderCommand());
+    RenderCommand& command = m_Commands.back();
+    command.type = type;
+    command.first = 0;
+    command.instanceCount = 0;
+    command.batchCount = 0;
+    command.placementCount = 0;
+    command.firstBatchEnd = 0;
+    command.color = glm::vec4(0.0f);
+    return command;
+}
+
+void RenderCommandBuffer::Clear(const glm::vec4& color)
+{
+    Push(RenderCommandType::Clear).color = color;
+}
+
+void RenderCommandBuffer::SetFrameConstants(const FrameConstants& constants)
+{
+    Push(RenderCommandType::SetFrameConstants).first = (unsigned int)m_Constants.size();
+    m_Constants.push_back(constants);
+}
+
+void RenderCommandBuffer::DrawAxes()
+{
+    Push(RenderCommandType::DrawAxes);
+}
+
+glm::mat4* RenderCommandBuffer::DrawCubies(unsigned int instanceCount, unsigned int batchCount, unsigned int placementCount, int*& batchEnds)
+{
+    RenderCommand& command = Push(RenderCommandType::DrawCubies);
+    command.first = m_MatrixCount;
+    command.instanceCount = instanceCount;
+    command.batchCount = batchCount;
+    command.placementCount = placementCount;
+    command.firstBatchEnd = (unsigned int)m_Ints.size();
+
+    m_MatrixCount += instanceCount + batchCount * placementCount;
+    if (m_Matrices.size() < m_MatrixCount)
+        m_Matrices.resize(m_MatrixCount);
+    m_Ints.resize(m_Ints.size() + batchCount);
+    batchEnds = m_Ints.data() + command.firstBatchEnd;
+    return m_Matrices.data() + command.first;
+}
+
+void RenderCommandBuffer::Capture(const std::string& filepath)
+{
+    Push(RenderCommandType::Capture).first = m_StringCount;
+    if (m_Strings.size() <= m_StringCount)
+        m_Strings.emplace_back();
+    m_Strings[m_StringCount++] = filepath;
+}
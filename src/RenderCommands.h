@@ -0,0 +1,77 @@
+#pragma once
+
+#include <UniformBuffer.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class RenderCommandType
+{
+    Clear,             // Clear color and depth to color
+    SetFrameConstants, // Upload constants[first] to the shared uniform block
+    DrawAxes,
+    DrawCubies,        // See RenderCommandBuffer::DrawCubies
+    Capture            // Read the frame back into the PNG at strings[first]
+};
+
+// One recorded command; what its fields mean depends on its type
+struct RenderCommand
+{
+    RenderCommandType type;
+    unsigned int first;
+    unsigned int instanceCount;
+    unsigned int batchCount;
+    unsigned int placementCount;
+    unsigned int firstBatchEnd;
+    glm::vec4 color;
+};
+
+// One frame of rendering recorded as plain data: commands in the order they run,
+// with their matrices and other data in flat arrays behind them. Recording makes
+// no GL calls, so a frame can be recorded on one thread and replayed on another
+// (see RenderThread). Reset keeps every array's capacity, so a buffer reused
+// frame after frame stops allocating once it has seen its largest frame.
+class RenderCommandBuffer
+{
+    private:
+        std::vector<RenderCommand> m_Commands;
+        // Matrices and strings only ever grow, the counts say how many this frame uses
+        std::vector<glm::mat4> m_Matrices;
+        unsigned int m_MatrixCount;
+        std::vector<std::string> m_Strings;
+        unsigned int m_StringCount;
+        std::vector<int> m_Ints;
+        std::vector<FrameConstants> m_Constants;
+        unsigned long long m_Frame;
+        uint64_t m_TurnsSettled;
+
+        RenderCommand& Push(RenderCommandType type);
+    public:
+        RenderCommandBuffer();
+
+        // Start recording frame over
+        void Reset(unsigned long long frame);
+        inline unsigned long long GetFrame() const { return m_Frame; }
+        // The CubeSnapshot::turnsSettled of the state the frame draws, to follow input to the screen
+        inline void SetTurnsSettled(uint64_t turnsSettled) { m_TurnsSettled = turnsSettled; }
+        inline uint64_t GetTurnsSettled() const { return m_TurnsSettled; }
+
+        void Clear(const glm::vec4& color);
+        void SetFrameConstants(const FrameConstants& constants);
+        void DrawAxes();
+        // The cubies as batches (the resting ones, then each turning layer) each drawn once per placement.
+        // Fill the matrices returned with instanceCount instance matrices, batch after batch, then batchCount
+        // matrices per placement (placement times the batch's rotation); fill batchEnds with the instance
+        // each batch ends at. Both stay valid until the next command is recorded
+        glm::mat4* DrawCubies(unsigned int instanceCount, unsigned int batchCount, unsigned int placementCount, int*& batchEnds);
+        void Capture(const std::string& filepath);
+
+        inline const std::vector<RenderCommand>& GetCommands() const { return m_Commands; }
+        inline const glm::mat4* GetMatrices(const RenderCommand& command) const { return m_Matrices.data() + command.first; }
+        inline const int* GetBatchEnds(const RenderCommand& command) const { return m_Ints.data() + command.firstBatchEnd; }
+        inline const FrameConstants& GetFrameConstants(const RenderCommand& command) const { return m_Constants[command.first]; }
+        inline const std::string& GetString(const RenderCommand& command) const { return m_Strings[command.first]; }
+};
@@ -0,0 +1,84 @@
+#include <RenderThread.h>
+#include <Debugger.h>
+#include <Profiler.h>
+
+RenderThread::RenderThread(const ContextBinder& bindContext, const FrameReplayer& replay, bool threaded)
+    : m_BindContext(bindContext), m_Replay(replay), m_Recorded(0), m_Replayed(0), m_Stopping(false)
+{
+    if (!threaded)
+        return;
+    // A context is current on one thread at a time, so it is let go here before the thread takes it
+    m_BindContext(false);
+    m_Thread = std::thread(&RenderThread::ThreadLoop, this);
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+RenderCommandBuffer& RenderThread::BeginFrame()
+{
+    PROFILE_SCOPE("WaitForRenderThread");
+    // The buffer comes free once the frame recorded into it two frames ago has been replayed
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_FrameReplayed.wait(lock, [this]() { return m_Replayed + s_BufferCount > m_Recorded; });
+    RenderCommandBuffer& buffer = m_Buffers[m_Recorded % s_BufferCount];
+    buffer.Reset(m_Recorded++);
+    return buffer;
+}
+
+void RenderThread::Submit()
+{
+    ASSERT(m_Recorded > 0);
+    RenderCommandBuffer& buffer = m_Buffers[(m_Recorded - 1) % s_BufferCount];
+    if (!IsThreaded())
+    {
+        m_Replay(buffer);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Replayed++;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Frames.push_back(&buffer);
+    }
+    m_FrameSubmitted.notify_one();
+}
+
+void RenderThread::Stop()
+{
+    if (!IsThreaded())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        // The thread keeps replaying until the queue is empty before it sees this
+        m_Stopping = true;
+    }
+    m_FrameSubmitted.notify_all();
+    m_Thread.join();
+    m_BindContext(true);
+}
+
+void RenderThread::ThreadLoop()
+{
+    m_BindContext(true);
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_FrameSubmitted.wait(lock, [this]() { return m_Stopping || !m_Frames.empty(); });
+        if (m_Frames.empty())
+            break;
+        RenderCommandBuffer* buffer = m_Frames.front();
+
+        // The buffer stays queued while it replays, nothing records into it until it is counted as replayed
+        lock.unlock();
+        m_Replay(*buffer);
+        lock.lock();
+        m_Frames.pop_front();
+        m_Replayed++;
+        m_FrameReplayed.notify_all();
+    }
+    lock.unlock();
+    m_BindContext(false);
+}
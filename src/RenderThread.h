@@ -0,0 +1,59 @@
+#pragma once
+
+#include <RenderCommands.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Replays recorded frames on a thread that owns the OpenGL context, so the main
+// thread can record frame N + 1 (input, simulation snapshot, transforms) while
+// frame N is submitted and swapped. Frames are replayed in order, and at most one
+// waits while another replays: BeginFrame holds the main thread back once it is
+// a full frame ahead.
+// Without a thread of its own (threaded false) Submit replays the frame right
+// away on the calling thread, the same commands through the same code.
+class RenderThread
+{
+    public:
+        // Makes the context current on the calling thread (true) or releases it (false)
+        typedef std::function<void(bool)> ContextBinder;
+        // Runs one frame's commands, and presents it
+        typedef std::function<void(const RenderCommandBuffer&)> FrameReplayer;
+    private:
+        static const unsigned int s_BufferCount = 2; // One recording, one replaying
+
+        ContextBinder m_BindContext;
+        FrameReplayer m_Replay;
+        RenderCommandBuffer m_Buffers[s_BufferCount];
+        unsigned long long m_Recorded; // Frames begun so far, the newest is being recorded
+
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_FrameSubmitted;
+        std::condition_variable m_FrameReplayed;
+        std::deque<RenderCommandBuffer*> m_Frames;
+        unsigned long long m_Replayed; // Frames replayed so far
+        bool m_Stopping;
+
+        void ThreadLoop();
+    public:
+        // Takes the context over from the calling thread when threaded
+        RenderThread(const ContextBinder& bindContext, const FrameReplayer& replay, bool threaded = true);
+        // Replays everything submitted and hands the context back
+        ~RenderThread();
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        inline bool IsThreaded() const { return m_Thread.joinable(); }
+
+        // The buffer to record the next frame into, reset; waits while both buffers are taken
+        RenderCommandBuffer& BeginFrame();
+        // Hand the frame recorded since BeginFrame over to be replayed
+        void Submit();
+        // Replay every submitted frame, stop the thread and make the context current on the calling thread
+        // again. A frame begun but not submitted is dropped
+        void Stop();
+};
@@ -1,14 +1,18 @@
 #include <Shader.h>
+#include <UniformBuffer.h>
+#include <GLState.h>
 
 Shader::Shader(const std::string& filepath)
     : m_Filepath(filepath), m_RendererID(0)
 {
     ShaderProgramSource source = ParseShader(filepath);
     m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    ReflectUniforms();
 }
 
 Shader::~Shader()
 {
+    GLState::ForgetProgram(m_RendererID);
     GLCall(glDeleteProgram(m_RendererID));
 }
 
@@ -84,17 +88,102 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
     GLCall(glDeleteShader(vs));
     GLCall(glDeleteShader(fs));
 
+    // Shaders that declare the per-frame block all read it from the same binding point
+    GLCall(unsigned int blockIndex = glGetUniformBlockIndex(program, "FrameConstants"));
+    if (blockIndex != GL_INVALID_INDEX)
+    {
+        GLCall(glUniformBlockBinding(program, blockIndex, FRAME_CONSTANTS_BINDING));
+    }
+
     return program;
 }
 
+void Shader::ReflectUniforms()
+{
+    int count = 0, maxLength = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+    std::string name(maxLength, '\0');
+    for (int i = 0; i < count; i++)
+    {
+        int length = 0, size = 0;
+        unsigned int type = 0;
+        GLCall(glGetActiveUniform(m_RendererID, i, maxLength, &length, &size, &type, &name[0]));
+        std::string uniformName = name.substr(0, length);
+
+        // Members of uniform blocks have no location of their own
+        GLCall(int location = glGetUniformLocation(m_RendererID, uniformName.c_str()));
+        if (location == -1)
+            continue;
+
+        // Arrays are reported as "name[0]", make them reachable by their plain name too
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+            uniformName.resize(uniformName.size() - 3);
+
+        m_Uniforms[uniformName] = { location, type, size };
+    }
+}
+
+template<typename T>
+static bool UniformTypeMatches(unsigned int type);
+
+template<>
+bool UniformTypeMatches<int>(unsigned int type)
+{
+    return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D;
+}
+
+template<>
+bool UniformTypeMatches<float>(unsigned int type)
+{
+    return type == GL_FLOAT;
+}
+
+template<>
+bool UniformTypeMatches<glm::vec4>(unsigned int type)
+{
+    return type == GL_FLOAT_VEC4;
+}
+
+template<>
+bool UniformTypeMatches<glm::mat4>(unsigned int type)
+{
+    return type == GL_FLOAT_MAT4;
+}
+
+template<typename T>
+UniformHandle<T> Shader::GetUniformHandle(const std::string& name) const
+{
+    auto it = m_Uniforms.find(name);
+    if (it == m_Uniforms.end())
+    {
+        std::cout << "Error: uniform '" << name << "' isn't active in " << m_Filepath << std::endl;
+        ASSERT(false);
+        return {};
+    }
+    if (!UniformTypeMatches<T>(it->second.type))
+    {
+        std::cout << "Error: uniform '" << name << "' in " << m_Filepath << " has GL type " << it->second.type << ", which doesn't match its handle" << std::endl;
+        ASSERT(false);
+        return {};
+    }
+    return { it->second.location };
+}
+
+template UniformHandle<int> Shader::GetUniformHandle<int>(const std::string& name) const;
+template UniformHandle<float> Shader::GetUniformHandle<float>(const std::string& name) const;
+template UniformHandle<glm::vec4> Shader::GetUniformHandle<glm::vec4>(const std::string& name) const;
+template UniformHandle<glm::mat4> Shader::GetUniformHandle<glm::mat4>(const std::string& name) const;
+
 void Shader::Bind() const
 {
-    GLCall(glUseProgram(m_RendererID));
+    GLState::UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-    GLCall(glUseProgram(0));
+    GLState::UseProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int value)
@@ -117,19 +206,43 @@ void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
-int Shader::GetUniformLocation(const std::string& name)
+void Shader::SetUniform(UniformHandle<int> handle, int value) const
 {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-    {
-        return m_UniformLocationCache[name];
-    }
+    GLCall(glUniform1i(handle.location, value));
+}
 
-    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1)
+void Shader::SetUniform(UniformHandle<float> handle, float value) const
+{
+    GLCall(glUniform1f(handle.location, value));
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec4> handle, const glm::vec4& value) const
+{
+    GLCall(glUniform4f(handle.location, value.x, value.y, value.z, value.w));
+}
+
+void Shader::SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix) const
+{
+    GLCall(glUniformMatrix4fv(handle.location, 1, GL_FALSE, &matrix[0][0]));
+}
+
+void Shader::SetUniform(UniformHandle<int> handle, const int* values, int count) const
+{
+    GLCall(glUniform1iv(handle.location, count, values));
+}
+
+void Shader::SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4* matrices, int count) const
+{
+    GLCall(glUniformMatrix4fv(handle.location, count, GL_FALSE, &matrices[0][0][0]));
+}
+
+int Shader::GetUniformLocation(const std::string& name)
+{
+    auto it = m_Uniforms.find(name);
+    if (it == m_Uniforms.end())
     {
         std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+        return -1;
     }
-    
-    m_UniformLocationCache[name] = location;
-    return location;
+    return it->second.location;
 }
\ No newline at end of file
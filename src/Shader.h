@@ -17,12 +17,28 @@ struct ShaderProgramSource
     std::string FragmentSource;
 };
 
+// An active uniform as reported by glGetActiveUniform after linking
+struct UniformInfo
+{
+    int location;
+    unsigned int type;
+    int size;
+};
+
+// Uniform location resolved and type-checked once, when the handle is created,
+// so hot-path uploads are a plain integer with no lookup or allocation
+template<typename T>
+struct UniformHandle
+{
+    int location = -1;
+};
+
 class Shader
 {
     private:
         std::string m_Filepath;
         unsigned int m_RendererID;
-        std::unordered_map<std::string, int> m_UniformLocationCache;
+        std::unordered_map<std::string, UniformInfo> m_Uniforms;
     public:
         Shader(const std::string& filepath);
         ~Shader();
@@ -35,10 +51,24 @@ class Shader
         void SetUniform1f(const std::string& name, float value);
         void SetUniform4f(const std::string& name, glm::vec4& value);
         void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+
+        // Resolve a uniform once; asserts if it is not active or its type does not match T
+        template<typename T>
+        UniformHandle<T> GetUniformHandle(const std::string& name) const;
+
+        // Set uniforms through pre-resolved handles (shader must be bound)
+        void SetUniform(UniformHandle<int> handle, int value) const;
+        void SetUniform(UniformHandle<float> handle, float value) const;
+        void SetUniform(UniformHandle<glm::vec4> handle, const glm::vec4& value) const;
+        void SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix) const;
+        // Arrays, from their first element on
+        void SetUniform(UniformHandle<int> handle, const int* values, int count) const;
+        void SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4* matrices, int count) const;
     private:
         ShaderProgramSource ParseShader(const std::string& filepath);
         unsigned int CompileShader(unsigned int type, const std::string& source);
         unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+        void ReflectUniforms();
 
         int GetUniformLocation(const std::string& name);
 };
\ No newline at end of file
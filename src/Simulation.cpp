@@ -0,0 +1,99 @@
+#include <Simulation.h>
+#include <Debugger.h>
+#include <Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+
+// Further behind than this, the thread skips ahead instead of running the missed steps back to back
+static const double s_MaxLagSeconds = 0.25;
+
+static int64_t ClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Simulation::Simulation(double stepSeconds)
+    : m_StepSeconds(stepSeconds), m_Steps(0), m_Running(false), m_EpochNs(ClockNs()), m_DroppedSeconds(0.0)
+{
+    ASSERT(stepSeconds > 0.0);
+    CubeSnapshot& snapshot = m_Snapshots.GetBack();
+    TakeSnapshot(snapshot);
+    snapshot.time = 0.0;
+    m_Snapshots.Publish();
+}
+
+Simulation::~Simulation()
+{
+    Stop();
+}
+
+void Simulation::Start()
+{
+    ASSERT(!IsRunning());
+    // Simulated time picks up from here, however long the simulation sat still
+    m_EpochNs.store(ClockNs() - (int64_t)(m_Steps * m_StepSeconds * 1e9));
+    m_Running.store(true);
+    m_Thread = std::thread(&Simulation::ThreadLoop, this);
+}
+
+void Simulation::Stop()
+{
+    if (!IsRunning())
+        return;
+    m_Running.store(false);
+    m_Thread.join();
+}
+
+void Simulation::Step()
+{
+    PROFILE_SCOPE("SimulationStep");
+    CubeSnapshot& snapshot = m_Snapshots.GetBack();
+    UpdateAnimation((float)m_StepSeconds, &snapshot);
+    m_Steps++;
+    snapshot.time = m_Steps * m_StepSeconds;
+    m_Snapshots.Publish();
+}
+
+void Simulation::ThreadLoop()
+{
+    const auto step = std::chrono::nanoseconds((int64_t)(m_StepSeconds * 1e9));
+    while (m_Running.load())
+    {
+        // A step runs once the clock has passed its end, so published snapshots are never ahead of frames
+        const int64_t stepEndNs = m_EpochNs.load() + (int64_t)((m_Steps + 1) * m_StepSeconds * 1e9);
+        const int64_t nowNs = ClockNs();
+        if (nowNs < stepEndNs)
+        {
+            std::this_thread::sleep_for(std::min(std::chrono::nanoseconds(stepEndNs - nowNs), step));
+            continue;
+        }
+        if (nowNs - stepEndNs > (int64_t)(s_MaxLagSeconds * 1e9))
+        {
+            // Running the missed steps would fast-forward the animation, drop the time instead
+            const int64_t dropped = nowNs - stepEndNs;
+            m_EpochNs.fetch_add(dropped);
+            m_DroppedSeconds += dropped * 1e-9;
+        }
+        Step();
+    }
+}
+
+void Simulation::AdvanceTo(double time)
+{
+    ASSERT(!IsRunning());
+    // The small margin keeps times that are whole steps on paper from losing a step to rounding
+    const uint64_t steps = (uint64_t)std::max(0.0, time / m_StepSeconds + 1e-6);
+    while (m_Steps < steps)
+        Step();
+}
+
+float Simulation::GetAlpha(const CubeSnapshot& snapshot, double time) const
+{
+    return (float)std::clamp((time - snapshot.time) / m_StepSeconds, 0.0, 1.0);
+}
+
+double Simulation::Now() const
+{
+    return (ClockNs() - m_EpochNs.load()) * 1e-9;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <CubeFaceRotations.h>
+#include <TripleBuffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Steps the cube simulation (move queue, animation and cube state, see
+// UpdateAnimation) at a fixed rate and publishes a CubeSnapshot after every step
+// through a triple buffer, so frames take whatever is newest without a lock.
+// A slow frame never stretches a step, and a slow step never holds up a frame.
+// Started, the simulation runs on its own thread paced by the clock and owns the
+// globals of CubeFaceRotations; the input thread may only push to g_moveQueue
+// and call QueueSolution. Not started, AdvanceTo steps it on the calling thread,
+// which keeps headless runs and benchmarks reproducible.
+class Simulation
+{
+    private:
+        double m_StepSeconds;
+        uint64_t m_Steps;
+        TripleBuffer<CubeSnapshot> m_Snapshots;
+
+        std::thread m_Thread;
+        std::atomic<bool> m_Running;
+        // Clock reading (steady clock, nanoseconds) at simulated time 0, moved on when time is dropped
+        std::atomic<int64_t> m_EpochNs;
+        double m_DroppedSeconds;
+
+        void Step();
+        void ThreadLoop();
+    public:
+        // Publishes the current state right away, so there is always a snapshot to draw
+        explicit Simulation(double stepSeconds = 1.0 / 120.0);
+        // Stops the thread
+        ~Simulation();
+        Simulation(const Simulation&) = delete;
+        Simulation& operator=(const Simulation&) = delete;
+
+        // Step on a thread of its own from now on, simulated time following the clock
+        void Start();
+        // Wait for the step in progress and join the thread
+        void Stop();
+        inline bool IsRunning() const { return m_Running.load(); }
+
+        // Not started only: take every step that ends by time (seconds since construction)
+        void AdvanceTo(double time);
+
+        // Render side: the newest snapshot, valid until the next call
+        inline const CubeSnapshot& Acquire() { return m_Snapshots.Acquire(); }
+        // Where a frame shown at time falls in a snapshot's step, from 0 (its start) to 1 (its end).
+        // Frames show the simulation one step late, interpolated between the last two states
+        float GetAlpha(const CubeSnapshot& snapshot, double time) const;
+        // Current simulated time by the clock, for GetAlpha while started
+        double Now() const;
+
+        inline double GetStepSeconds() const { return m_StepSeconds; }
+        // Not while started
+        inline uint64_t GetStepCount() const { return m_Steps; }
+        // Time skipped instead of caught up with after the thread fell far behind (a debugger, a suspended process)
+        inline double GetDroppedSeconds() const { return m_DroppedSeconds; }
+};
@@ -0,0 +1,70 @@
+#include <SolveBatch.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t SolveBatch(JobSystem& jobs, const std::vector<CubeState>& states, const SolveFunction& solve,
+                  const SolveResultCallback& onResult, const std::atomic<bool>* cancel)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<SolveResult> results(states.size());
+    std::vector<unsigned char> done(states.size(), 0);
+    size_t doneCount = 0;
+    std::mutex mutex;
+    std::condition_variable resultReady;
+    std::atomic<bool> stopped(false);
+
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        jobs.Submit([&, i]()
+        {
+            SolveResult& result = results[i];
+            result.index = i;
+            result.solved = false;
+            result.cancelled = stopped || (cancel && *cancel);
+            result.solveMs = 0.0;
+            result.waitMs = MillisecondsSince(start);
+            result.worker = JobSystem::GetCurrentWorker();
+            if (!result.cancelled)
+            {
+                const auto solveStart = std::chrono::steady_clock::now();
+                result.solved = solve(states[i], result.moves);
+                result.solveMs = MillisecondsSince(solveStart);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            done[i] = 1;
+            doneCount++;
+            resultReady.notify_all();
+        });
+    }
+
+    // Results go out in order: each one waits for all those before it
+    size_t delivered = 0;
+    for (size_t next = 0; next < states.size() && !stopped; next++)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            resultReady.wait(lock, [&]() { return done[next] != 0; });
+        }
+        if (results[next].cancelled || (cancel && *cancel))
+        {
+            stopped = true;
+            break;
+        }
+        delivered++;
+        if (!onResult(results[next]))
+            stopped = true;
+    }
+
+    // The jobs reference this frame, so every one of them has to be through before it goes.
+    // Those that start from now on see stopped and return straight away
+    std::unique_lock<std::mutex> lock(mutex);
+    resultReady.wait(lock, [&]() { return doneCount == states.size(); });
+    return delivered;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <CubeState.h>
+#include <JobSystem.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// One cube of a batch
+struct SolveResult
+{
+    size_t index;           // Into the batch
+    bool solved;
+    bool cancelled;         // Skipped, the batch was cancelled before this cube's turn came
+    std::vector<int> moves; // CubeState numbering
+    double solveMs;         // Time spent in the solver
+    double waitMs;          // Time from the batch start until a worker took it
+    int worker;             // JobSystem worker that solved it
+};
+
+// Any solver: fills in the moves solving a state, false when it found none
+typedef std::function<bool(const CubeState& state, std::vector<int>& moves)> SolveFunction;
+// Called with every result, in batch order; returning false cancels the rest of the batch
+typedef std::function<bool(const SolveResult& result)> SolveResultCallback;
+
+// Solve every state in its own job on jobs, and hand the results to onResult on the calling thread
+// in batch order, each one as soon as it and all before it are done. Setting cancel (optional,
+// from any thread) or returning false from onResult skips the solves not started yet and stops
+// the results; solves already running finish first. Returns how many results were handed over.
+// Call it from outside the pool's jobs.
+// solve runs on several threads at once: both solvers are read-only and fit, as long as the
+// optimal one is asked for a single thread per solve
+size_t SolveBatch(JobSystem& jobs, const std::vector<CubeState>& states, const SolveFunction& solve,
+                  const SolveResultCallback& onResult, const std::atomic<bool>* cancel = nullptr);
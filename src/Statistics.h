@@ -0,0 +1,16 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// The p-th percentile (0 to 100) of sorted values by nearest rank: the smallest
+// value with at least p percent of the values at or below it, so p95 of 20 values
+// is the 19th. Every report uses this one, so a p95 means the same in all of them
+inline double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
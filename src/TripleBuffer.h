@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+
+// Hands whole values from one writer thread to one reader thread without a lock
+// and without either side ever waiting for the other. Of the three slots the
+// writer owns one (the back), the reader owns one (the front) and the third (the
+// middle) holds the newest published value. Publishing swaps the back with the
+// middle, reading swaps the middle with the front when something new is there;
+// each swap is a single atomic exchange, so a slot always belongs to exactly one
+// side and the values themselves need no locking.
+// The back slot handed to the writer holds some older value, not necessarily
+// the last one it published.
+template<typename T>
+class TripleBuffer
+{
+    private:
+        // Set next to the middle slot's index while it holds a value the reader hasn't taken yet
+        static const unsigned int s_Fresh = 4;
+
+        T m_Slots[3];
+        alignas(64) std::atomic<unsigned int> m_Middle;
+        alignas(64) unsigned int m_Back;  // Writer only
+        alignas(64) unsigned int m_Front; // Reader only
+    public:
+        TripleBuffer()
+            : m_Middle(1), m_Back(0), m_Front(2)
+        {
+        }
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer: the slot to fill, then Publish it
+        inline T& GetBack() { return m_Slots[m_Back]; }
+        inline void Publish()
+        {
+            m_Back = m_Middle.exchange(m_Back | s_Fresh, std::memory_order_acq_rel) & 3;
+        }
+
+        // Reader: the newest published value, left alone by the writer until the next Acquire.
+        // Before anything is published, a default constructed T
+        inline const T& Acquire()
+        {
+            if (m_Middle.load(std::memory_order_relaxed) & s_Fresh)
+                m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & 3;
+            return m_Slots[m_Front];
+        }
+};
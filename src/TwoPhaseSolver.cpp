@@ -0,0 +1,591 @@
+#include <TwoPhaseSolver.h>
+#include <CubeSymmetry.h>
+#include <Debugger.h>
+#include <MoveSequence.h>
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+// Phase 2 moves in CubeState numbering: U, U2, U', R2, F2, D, D2, D', L2, B2
+static const int s_Phase2Moves[TwoPhaseSolver::PHASE2_MOVE_COUNT] = { 0, 1, 2, 4, 7, 9, 10, 11, 13, 16 };
+
+// Longest search either phase ever needs (12 and 18 moves), with room to spare
+static const int MAX_DEPTH = 32;
+// The cube is searched seen along each of the three axes, and so is its inverse
+static const int VIEW_COUNT = 2 * CubeSymmetry::AXIS_COUNT;
+
+// Bumped whenever a coordinate or table layout changes, so stale caches are rebuilt
+static const uint32_t TABLES_MAGIC = 0x32504B54; // "TKP2"
+static const uint32_t TABLES_VERSION = 3;
+
+// A 4 bit distance not filled in yet; phase 1 never needs more than 12 moves
+static const unsigned char UNVISITED = 15;
+
+static int Choose(int n, int k)
+{
+    if (k < 0 || k > n)
+        return 0;
+    int result = 1;
+    for (int i = 0; i < k; i++)
+        result = result * (n - i) / (i + 1);
+    return result;
+}
+
+// Lehmer code of a permutation of 0 .. count - 1
+static int PermutationRank(const unsigned char* permutation, int count)
+{
+    int rank = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int smaller = 0;
+        for (int j = i + 1; j < count; j++)
+            smaller += permutation[j] < permutation[i];
+        rank = rank * (count - i) + smaller;
+    }
+    return rank;
+}
+
+int TwoPhaseSolver::GetTwist(const CubeState& state)
+{
+    int twist = 0;
+    for (int i = 0; i < CubeState::CORNER_COUNT - 1; i++)
+        twist = twist * 3 + state.co[i];
+    return twist;
+}
+
+int TwoPhaseSolver::GetFlip(const CubeState& state)
+{
+    int flip = 0;
+    for (int i = 0; i < CubeState::EDGE_COUNT - 1; i++)
+        flip = flip * 2 + state.eo[i];
+    return flip;
+}
+
+int TwoPhaseSolver::GetSliceSorted(const CubeState& state)
+{
+    // Which four slots hold the middle-layer edges (FR, FL, BL, BR), then their order in those slots
+    int positions = 0, found = 0;
+    unsigned char order[4];
+    for (int slot = CubeState::EDGE_COUNT - 1; slot >= 0; slot--)
+    {
+        if (state.ep[slot] >= CubeState::FR)
+        {
+            positions += Choose(CubeState::EDGE_COUNT - 1 - slot, found + 1);
+            order[3 - found] = (unsigned char)(state.ep[slot] - CubeState::FR);
+            found++;
+        }
+    }
+    return positions * SLICE_PERM_COUNT + PermutationRank(order, 4);
+}
+
+// Edge flips of every slot from the flip coordinate, the last one making the sum even
+static void SetFlip(CubeState& state, int flip)
+{
+    int flipSum = 0;
+    for (int i = CubeState::EDGE_COUNT - 2; i >= 0; i--)
+    {
+        state.eo[i] = (unsigned char)(flip & 1);
+        flipSum += state.eo[i];
+        flip >>= 1;
+    }
+    state.eo[CubeState::EDGE_COUNT - 1] = (unsigned char)(flipSum & 1);
+}
+
+static inline int GetDistance(const std::vector<unsigned char>& table, uint32_t entry)
+{
+    return (table[entry >> 1] >> ((entry & 1) * 4)) & 15;
+}
+
+static inline void SetDistance(std::vector<unsigned char>& table, uint32_t entry, int distance)
+{
+    const int shift = (entry & 1) * 4;
+    table[entry >> 1] = (unsigned char)((table[entry >> 1] & ~(15 << shift)) | distance << shift);
+}
+
+int TwoPhaseSolver::GetCornerPerm(const CubeState& state)
+{
+    return PermutationRank(state.cp, CubeState::CORNER_COUNT);
+}
+
+int TwoPhaseSolver::GetEdge8Perm(const CubeState& state)
+{
+    return PermutationRank(state.ep, 8);
+}
+
+// Move table of one coordinate, found by walking every value it can take from the solved
+// cube and keeping one cube per value to take the next moves from
+template<typename Coordinate>
+static void BuildMoveTable(std::vector<unsigned short>& table, int count, const int* moves, int moveCount, Coordinate coordinate)
+{
+    table.assign((size_t)count * moveCount, 0);
+    std::vector<CubeState> cubes(count);
+    std::vector<bool> seen(count, false);
+    std::vector<int> queue;
+    queue.reserve(count);
+    queue.push_back(0);
+    seen[0] = true;
+    for (size_t next = 0; next < queue.size(); next++)
+    {
+        const int value = queue[next];
+        for (int i = 0; i < moveCount; i++)
+        {
+            CubeState cube = cubes[value];
+            cube.ApplyMove(moves[i]);
+            const int moved = coordinate(cube);
+            ASSERT(moved >= 0 && moved < count);
+            table[(size_t)value * moveCount + i] = (unsigned short)moved;
+            if (!seen[moved])
+            {
+                seen[moved] = true;
+                cubes[moved] = cube;
+                queue.push_back(moved);
+            }
+        }
+    }
+    ASSERT((int)queue.size() == count);
+}
+
+// Breadth-first distances from index 0 over a pair of coordinates
+template<typename Neighbor>
+static void BuildPruneTable(std::vector<unsigned char>& table, size_t size, int moveCount, Neighbor neighbor)
+{
+    table.assign(size, 0xFF);
+    std::vector<uint32_t> frontier(1, 0), next;
+    table[0] = 0;
+    for (unsigned char depth = 0; !frontier.empty(); depth++)
+    {
+        next.clear();
+        for (uint32_t index : frontier)
+        {
+            for (int move = 0; move < moveCount; move++)
+            {
+                const size_t moved = neighbor(index, move);
+                if (table[moved] == 0xFF)
+                {
+                    table[moved] = depth + 1;
+                    next.push_back((uint32_t)moved);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+}
+
+int TwoPhaseSolver::GetPhase1Entry(int twist, int flip, int slice) const
+{
+    const uint32_t classOf = m_FlipSliceClass[flip * SLICE_COUNT + slice];
+    return (int)(classOf >> 4) * TWIST_COUNT + m_CornerSymmetry.ConjugateTwist(twist, classOf & 15);
+}
+
+int TwoPhaseSolver::GetPhase1Distance(int twist, int flip, int slice) const
+{
+    return GetDistance(m_Phase1Prune, GetPhase1Entry(twist, flip, slice));
+}
+
+void TwoPhaseSolver::BuildFlipSliceClasses()
+{
+    // A cube for every slice position, with the middle-layer edges in those four slots
+    std::vector<CubeState> sliceCubes(SLICE_COUNT);
+    for (unsigned slots = 0; slots < 1u << CubeState::EDGE_COUNT; slots++)
+    {
+        if (std::bitset<CubeState::EDGE_COUNT>(slots).count() != 4)
+            continue;
+        CubeState cube;
+        int middle = CubeState::FR, other = 0;
+        for (int slot = 0; slot < CubeState::EDGE_COUNT; slot++)
+            cube.ep[slot] = (unsigned char)(slots & (1u << slot) ? middle++ : other++);
+        sliceCubes[GetSliceSorted(cube) / SLICE_PERM_COUNT] = cube;
+    }
+
+    // U-D symmetries keep the middle layer in place, so the flip-slice of a conjugate depends on the
+    // flip-slice alone. As for the corners, the smallest flip-slice of every class is its representative
+    m_FlipSliceClass.assign(FLIP_SLICE_COUNT, UINT32_MAX);
+    m_FlipSliceRepresentative.resize(FLIP_SLICE_CLASS_COUNT);
+    m_FlipSliceStabilizer.resize(FLIP_SLICE_CLASS_COUNT);
+    int classCount = 0;
+    for (int flipSlice = 0; flipSlice < FLIP_SLICE_COUNT; flipSlice++)
+    {
+        if (m_FlipSliceClass[flipSlice] != UINT32_MAX)
+            continue;
+        ASSERT(classCount < FLIP_SLICE_CLASS_COUNT);
+        m_FlipSliceRepresentative[classCount] = (uint32_t)flipSlice;
+        m_FlipSliceStabilizer[classCount] = 0;
+        CubeState cube = sliceCubes[flipSlice % SLICE_COUNT];
+        SetFlip(cube, flipSlice / SLICE_COUNT);
+        for (int symmetry = 0; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+        {
+            const CubeState conjugate = CubeSymmetry::Conjugate(cube, symmetry);
+            const int reached = GetFlip(conjugate) * SLICE_COUNT + GetSliceSorted(conjugate) / SLICE_PERM_COUNT;
+            if (reached == flipSlice)
+                m_FlipSliceStabilizer[classCount] |= (uint16_t)(1 << symmetry);
+            if (m_FlipSliceClass[reached] == UINT32_MAX)
+                m_FlipSliceClass[reached] = (uint32_t)classCount << 4 | (uint32_t)CubeSymmetry::GetInverse(symmetry);
+        }
+        classCount++;
+    }
+    ASSERT(classCount == FLIP_SLICE_CLASS_COUNT);
+}
+
+// Exact phase 1 distances, one breadth-first level at a time: forward from the entries just
+// reached while they are few, then backward from every entry left, looking for a neighbor on
+// the last level. An entry stands for its representative's flip-slice; a class with symmetries
+// of its own has several entries for states symmetric to each other, and going forward they
+// are all reached along with the one a move leads to
+void TwoPhaseSolver::BuildPhase1Prune()
+{
+    auto neighbor = [this](uint32_t entry, int move) {
+        const int flipSlice = (int)m_FlipSliceRepresentative[entry / TWIST_COUNT];
+        const int flip = m_FlipMoves[flipSlice / SLICE_COUNT * CubeState::MOVE_COUNT + move];
+        const int slice = m_SliceSortedMoves[flipSlice % SLICE_COUNT * SLICE_PERM_COUNT * CubeState::MOVE_COUNT + move] / SLICE_PERM_COUNT;
+        const int twist = m_TwistMoves[entry % TWIST_COUNT * CubeState::MOVE_COUNT + move];
+        return (uint32_t)GetPhase1Entry(twist, flip, slice);
+    };
+
+    m_Phase1Prune.assign((PHASE1_ENTRY_COUNT + 1) / 2, 0xFF);
+    SetDistance(m_Phase1Prune, 0, 0);
+    uint32_t reached = 1, lastLevel = 1;
+    for (int depth = 0; reached < (uint32_t)PHASE1_ENTRY_COUNT; depth++)
+    {
+        const bool backward = lastLevel > PHASE1_ENTRY_COUNT - reached;
+        uint32_t found = 0;
+        for (uint32_t entry = 0; entry < (uint32_t)PHASE1_ENTRY_COUNT; entry++)
+        {
+            const int distance = GetDistance(m_Phase1Prune, entry);
+            if (backward)
+            {
+                if (distance != UNVISITED)
+                    continue;
+                for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+                {
+                    if (GetDistance(m_Phase1Prune, neighbor(entry, move)) == depth)
+                    {
+                        SetDistance(m_Phase1Prune, entry, depth + 1);
+                        found++;
+                        break;
+                    }
+                }
+                continue;
+            }
+            if (distance != depth)
+                continue;
+            for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+            {
+                const uint32_t moved = neighbor(entry, move);
+                if (GetDistance(m_Phase1Prune, moved) != UNVISITED)
+                    continue;
+                SetDistance(m_Phase1Prune, moved, depth + 1);
+                found++;
+                const uint32_t classIndex = moved / TWIST_COUNT;
+                const int stabilizer = m_FlipSliceStabilizer[classIndex];
+                for (int symmetry = 1; symmetry < CubeSymmetry::UD_COUNT; symmetry++)
+                {
+                    if (!(stabilizer & (1 << symmetry)))
+                        continue;
+                    const uint32_t symmetric = classIndex * TWIST_COUNT + m_CornerSymmetry.ConjugateTwist(moved % TWIST_COUNT, symmetry);
+                    if (GetDistance(m_Phase1Prune, symmetric) == UNVISITED)
+                    {
+                        SetDistance(m_Phase1Prune, symmetric, depth + 1);
+                        found++;
+                    }
+                }
+            }
+        }
+        ASSERT(found > 0);
+        lastLevel = found;
+        reached += found;
+    }
+}
+
+void TwoPhaseSolver::BuildTables()
+{
+    int allMoves[CubeState::MOVE_COUNT];
+    for (int i = 0; i < CubeState::MOVE_COUNT; i++)
+        allMoves[i] = i;
+
+    BuildMoveTable(m_TwistMoves, TWIST_COUNT, allMoves, CubeState::MOVE_COUNT, GetTwist);
+    BuildMoveTable(m_FlipMoves, FLIP_COUNT, allMoves, CubeState::MOVE_COUNT, GetFlip);
+    BuildMoveTable(m_SliceSortedMoves, SLICE_SORTED_COUNT, allMoves, CubeState::MOVE_COUNT, GetSliceSorted);
+    BuildMoveTable(m_CornerPermMoves, CORNER_PERM_COUNT, allMoves, CubeState::MOVE_COUNT, GetCornerPerm);
+    BuildMoveTable(m_Edge8PermMoves, EDGE8_PERM_COUNT, s_Phase2Moves, PHASE2_MOVE_COUNT, GetEdge8Perm);
+
+    BuildFlipSliceClasses();
+    BuildPhase1Prune();
+    BuildPruneTable(m_TwistSlicePrune, (size_t)TWIST_COUNT * SLICE_COUNT, CubeState::MOVE_COUNT, [&](uint32_t index, int move) {
+        return (size_t)m_TwistMoves[index / SLICE_COUNT * CubeState::MOVE_COUNT + move] * SLICE_COUNT
+            + m_SliceSortedMoves[index % SLICE_COUNT * SLICE_PERM_COUNT * CubeState::MOVE_COUNT + move] / SLICE_PERM_COUNT;
+    });
+    BuildPruneTable(m_FlipSlicePrune, (size_t)FLIP_COUNT * SLICE_COUNT, CubeState::MOVE_COUNT, [&](uint32_t index, int move) {
+        return (size_t)m_FlipMoves[index / SLICE_COUNT * CubeState::MOVE_COUNT + move] * SLICE_COUNT
+            + m_SliceSortedMoves[index % SLICE_COUNT * SLICE_PERM_COUNT * CubeState::MOVE_COUNT + move] / SLICE_PERM_COUNT;
+    });
+
+    // In phase 2 the middle-layer edges stay put, so their sorted coordinate is just their order
+    auto slicePermMove = [this](int slicePerm, int move) {
+        return m_SliceSortedMoves[(size_t)slicePerm * CubeState::MOVE_COUNT + s_Phase2Moves[move]];
+    };
+    BuildPruneTable(m_CornerSlicePrune, (size_t)CORNER_PERM_COUNT * SLICE_PERM_COUNT, PHASE2_MOVE_COUNT, [&](uint32_t index, int move) {
+        return (size_t)m_CornerPermMoves[index / SLICE_PERM_COUNT * CubeState::MOVE_COUNT + s_Phase2Moves[move]] * SLICE_PERM_COUNT + slicePermMove(index % SLICE_PERM_COUNT, move);
+    });
+    BuildPruneTable(m_Edge8SlicePrune, (size_t)EDGE8_PERM_COUNT * SLICE_PERM_COUNT, PHASE2_MOVE_COUNT, [&](uint32_t index, int move) {
+        return (size_t)m_Edge8PermMoves[index / SLICE_PERM_COUNT * PHASE2_MOVE_COUNT + move] * SLICE_PERM_COUNT + slicePermMove(index % SLICE_PERM_COUNT, move);
+    });
+}
+
+bool TwoPhaseSolver::LoadTables(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    uint32_t header[2];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != TABLES_MAGIC || header[1] != TABLES_VERSION)
+        return false;
+
+    auto read = [&file](auto& table, size_t count) {
+        table.resize(count);
+        return (bool)file.read(reinterpret_cast<char*>(table.data()), count * sizeof(table[0]));
+    };
+    return read(m_TwistMoves, (size_t)TWIST_COUNT * CubeState::MOVE_COUNT)
+        && read(m_FlipMoves, (size_t)FLIP_COUNT * CubeState::MOVE_COUNT)
+        && read(m_SliceSortedMoves, (size_t)SLICE_SORTED_COUNT * CubeState::MOVE_COUNT)
+        && read(m_CornerPermMoves, (size_t)CORNER_PERM_COUNT * CubeState::MOVE_COUNT)
+        && read(m_Edge8PermMoves, (size_t)EDGE8_PERM_COUNT * PHASE2_MOVE_COUNT)
+        && read(m_FlipSliceClass, (size_t)FLIP_SLICE_COUNT)
+        && read(m_FlipSliceRepresentative, (size_t)FLIP_SLICE_CLASS_COUNT)
+        && read(m_FlipSliceStabilizer, (size_t)FLIP_SLICE_CLASS_COUNT)
+        && read(m_Phase1Prune, ((size_t)PHASE1_ENTRY_COUNT + 1) / 2)
+        && read(m_TwistSlicePrune, (size_t)TWIST_COUNT * SLICE_COUNT)
+        && read(m_FlipSlicePrune, (size_t)FLIP_COUNT * SLICE_COUNT)
+        && read(m_CornerSlicePrune, (size_t)CORNER_PERM_COUNT * SLICE_PERM_COUNT)
+        && read(m_Edge8SlicePrune, (size_t)EDGE8_PERM_COUNT * SLICE_PERM_COUNT)
+        && file.peek() == std::ifstream::traits_type::eof();
+}
+
+bool TwoPhaseSolver::SaveTables(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    const uint32_t header[2] = { TABLES_MAGIC, TABLES_VERSION };
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    auto write = [&file](const auto& table) {
+        file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(table[0]));
+    };
+    write(m_TwistMoves);
+    write(m_FlipMoves);
+    write(m_SliceSortedMoves);
+    write(m_CornerPermMoves);
+    write(m_Edge8PermMoves);
+    write(m_FlipSliceClass);
+    write(m_FlipSliceRepresentative);
+    write(m_FlipSliceStabilizer);
+    write(m_Phase1Prune);
+    write(m_TwistSlicePrune);
+    write(m_FlipSlicePrune);
+    write(m_CornerSlicePrune);
+    write(m_Edge8SlicePrune);
+    return (bool)file;
+}
+
+TwoPhaseSolver::TwoPhaseSolver(const std::string& cachePath)
+    : m_CornerSymmetry(CornerSymmetry::Get())
+{
+    if (!cachePath.empty() && LoadTables(cachePath))
+        return;
+
+    std::cout << "Building two-phase solver tables..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    BuildTables();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Solver tables built in " << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+
+    if (!cachePath.empty() && !SaveTables(cachePath))
+        std::cout << "Warning: couldn't write the solver tables to " << cachePath << std::endl;
+}
+
+struct TwoPhaseSolver::Search
+{
+    const TwoPhaseSolver& solver;
+    // Each view is the cube, or its inverse, seen through the rotation bringing one axis to U-D. All of them
+    // are as far from solved, but their phase 1 solutions differ, and one often leads to a much shorter total
+    CubeState views[VIEW_COUNT];
+    int view = 0;
+    int targetLength;
+    std::chrono::steady_clock::time_point deadline;
+    unsigned int nodes = 0;
+    bool timedOut = false;
+
+    int moves[MAX_DEPTH];
+    // The first solution of at most targetLength moves, for the cube itself; length 0 until there is one
+    int solution[MAX_DEPTH];
+    int solutionLength = 0;
+
+    Search(const TwoPhaseSolver& solver, const CubeState& start, int targetLength, double timeoutMs)
+        : solver(solver), targetLength(targetLength),
+          deadline(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(timeoutMs)))
+    {
+        const CubeState inverse = start.GetInverse();
+        for (int axis = 0; axis < CubeSymmetry::AXIS_COUNT; axis++)
+        {
+            views[axis] = CubeSymmetry::Conjugate(start, CubeSymmetry::GetAxisRotation(axis));
+            views[CubeSymmetry::AXIS_COUNT + axis] = CubeSymmetry::Conjugate(inverse, CubeSymmetry::GetAxisRotation(axis));
+        }
+    }
+
+    // The moves solving the current view turned into moves solving the cube itself
+    void KeepSolution(int length)
+    {
+        const int back = CubeSymmetry::GetInverse(CubeSymmetry::GetAxisRotation(view % CubeSymmetry::AXIS_COUNT));
+        const bool inverse = view >= CubeSymmetry::AXIS_COUNT;
+        for (int i = 0; i < length; i++)
+        {
+            const int move = CubeSymmetry::ConjugateMove(moves[i], back);
+            // What solves the inverse is the inverse of a solution: the same moves backward, each turned back
+            if (inverse)
+                solution[length - 1 - i] = move - move % 3 + 2 - move % 3;
+            else
+                solution[i] = move;
+        }
+        solutionLength = length;
+    }
+
+    // Looking at the clock is slow next to a node, so only every few thousand
+    bool OutOfTime()
+    {
+        if ((++nodes & 4095) == 0 && std::chrono::steady_clock::now() > deadline)
+            timedOut = true;
+        return timedOut;
+    }
+
+    // The corner permutation comes along, so most phase 1 solutions are turned down before the cube is built
+    bool Phase1(int twist, int flip, int slice, int corners, int depth, int togo)
+    {
+        if (togo == 0)
+        {
+            // Ending on a phase 2 move means a shorter phase 1 solution was already tried
+            if (depth > 0 && std::find(s_Phase2Moves, s_Phase2Moves + PHASE2_MOVE_COUNT, moves[depth - 1]) != s_Phase2Moves + PHASE2_MOVE_COUNT)
+                return false;
+            return StartPhase2(corners, slice, depth);
+        }
+        if (OutOfTime())
+            return false;
+
+        const int previous = depth > 0 ? moves[depth - 1] : -1;
+        for (int move = 0; move < CubeState::MOVE_COUNT; move++)
+        {
+            if (!MoveSequence::CanFollow(previous, move))
+                continue;
+            const int movedSlice = solver.m_SliceSortedMoves[slice * CubeState::MOVE_COUNT + move];
+            const int movedTwist = solver.m_TwistMoves[twist * CubeState::MOVE_COUNT + move];
+            const int movedFlip = solver.m_FlipMoves[flip * CubeState::MOVE_COUNT + move];
+            if (solver.m_TwistSlicePrune[movedTwist * SLICE_COUNT + movedSlice / SLICE_PERM_COUNT] >= togo
+                || solver.m_FlipSlicePrune[movedFlip * SLICE_COUNT + movedSlice / SLICE_PERM_COUNT] >= togo)
+                continue;
+            if (solver.GetPhase1Distance(movedTwist, movedFlip, movedSlice / SLICE_PERM_COUNT) >= togo)
+                continue;
+            moves[depth] = move;
+            if (Phase1(movedTwist, movedFlip, movedSlice, solver.m_CornerPermMoves[corners * CubeState::MOVE_COUNT + move], depth + 1, togo - 1))
+                return true;
+            if (timedOut)
+                return false;
+        }
+        return false;
+    }
+
+    bool StartPhase2(int corners, int slice, int depth)
+    {
+        ASSERT(slice < SLICE_PERM_COUNT);
+        // Only a solution short enough ends the search, longer ones aren't worth looking for
+        const int maxTogo = std::min((int)MAX_PHASE2_DEPTH, targetLength - depth);
+        if (solver.m_CornerSlicePrune[corners * SLICE_PERM_COUNT + slice] > maxTogo)
+            return false;
+
+        // The U and D layer edges only have a phase 2 coordinate once they are back in those layers,
+        // so theirs comes from the cube itself
+        CubeState cube = views[view];
+        for (int i = 0; i < depth; i++)
+            cube.ApplyMove(moves[i]);
+        const int edges = GetEdge8Perm(cube);
+        const int bound = std::max(solver.m_CornerSlicePrune[corners * SLICE_PERM_COUNT + slice],
+                                   solver.m_Edge8SlicePrune[edges * SLICE_PERM_COUNT + slice]);
+        for (int togo = bound; togo <= maxTogo; togo++)
+        {
+            if (Phase2(corners, edges, slice, depth, togo))
+            {
+                KeepSolution(depth + togo);
+                return true;
+            }
+            if (timedOut)
+                return false;
+        }
+        return false;
+    }
+
+    bool Phase2(int corners, int edges, int slice, int depth, int togo)
+    {
+        if (togo == 0)
+            return corners == 0 && edges == 0 && slice == 0;
+        if (OutOfTime())
+            return false;
+
+        const int previous = depth > 0 ? moves[depth - 1] : -1;
+        for (int i = 0; i < PHASE2_MOVE_COUNT; i++)
+        {
+            const int move = s_Phase2Moves[i];
+            if (!MoveSequence::CanFollow(previous, move))
+                continue;
+            const int movedSlice = solver.m_SliceSortedMoves[slice * CubeState::MOVE_COUNT + move];
+            const int movedCorners = solver.m_CornerPermMoves[corners * CubeState::MOVE_COUNT + move];
+            if (solver.m_CornerSlicePrune[movedCorners * SLICE_PERM_COUNT + movedSlice] >= togo)
+                continue;
+            const int movedEdges = solver.m_Edge8PermMoves[edges * PHASE2_MOVE_COUNT + i];
+            if (solver.m_Edge8SlicePrune[movedEdges * SLICE_PERM_COUNT + movedSlice] >= togo)
+                continue;
+            moves[depth] = move;
+            if (Phase2(movedCorners, movedEdges, movedSlice, depth + 1, togo - 1))
+                return true;
+            if (timedOut)
+                return false;
+        }
+        return false;
+    }
+};
+
+bool TwoPhaseSolver::Solve(const CubeState& state, std::vector<int>& moves, int maxLength, double timeoutMs) const
+{
+    moves.clear();
+    if (!state.IsValid())
+        return false;
+    if (state.IsSolved())
+        return true;
+    Search search(*this, state, maxLength, timeoutMs);
+    int twists[VIEW_COUNT], flips[VIEW_COUNT], slices[VIEW_COUNT], corners[VIEW_COUNT], bounds[VIEW_COUNT];
+    for (int view = 0; view < VIEW_COUNT; view++)
+    {
+        twists[view] = GetTwist(search.views[view]);
+        flips[view] = GetFlip(search.views[view]);
+        slices[view] = GetSliceSorted(search.views[view]);
+        corners[view] = GetCornerPerm(search.views[view]);
+        bounds[view] = GetPhase1Distance(twists[view], flips[view], slices[view] / SLICE_PERM_COUNT);
+    }
+    // Every phase 1 length is tried on all the views before the next, so none of them holds the others up
+    bool done = false;
+    for (int depth = *std::min_element(bounds, bounds + VIEW_COUNT); !done && depth <= maxLength && depth < MAX_DEPTH; depth++)
+    {
+        for (int view = 0; view < VIEW_COUNT && !done; view++)
+        {
+            if (depth < bounds[view])
+                continue;
+            search.view = view;
+            done = search.Phase1(twists[view], flips[view], slices[view], corners[view], 0, depth) || search.timedOut;
+        }
+    }
+    if (search.solutionLength == 0)
+        return false;
+    moves.assign(search.solution, search.solution + search.solutionLength);
+    return true;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <CubeState.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CornerSymmetry;
+
+// Kociemba's two-phase algorithm on the 3x3x3 CubeState.
+// Phase 1 takes the cube into the subgroup <U, D, R2, F2, L2, B2>: every piece
+// oriented and the four middle-layer edges in the middle layer. Phase 2 solves it
+// with those moves only. Both phases are IDA* searches over small integer
+// coordinates of the cube, turned by move tables and bounded by pruning tables.
+// Phase 1 has the exact distance of every state: flip and slice positions
+// together are stored once per class of the 16 U-D symmetries (as CornerSymmetry
+// does for the corners), 64430 classes, each with every twist, 4 bits an entry.
+// Coarser bounds over twist or flip with the slice positions alone stay in cache
+// and turn most moves down before that table is read.
+// Phase 2 has exact distances over pairs of its coordinates. Phase 1 solutions
+// are tried in increasing length and each one is handed to a phase 2 search of
+// at most MAX_PHASE2_DEPTH moves, short enough for the total to stay within the
+// length asked for. As in Kociemba's and Chen Shuang's (min2phase) solvers, the
+// cube is searched seen along each of the three axes, and so is its inverse, one
+// phase 1 length at a time: the six have different phase 1 solutions, and one of
+// them usually leads to a short enough total within a few milliseconds.
+//
+// The tables take a moment to build, so they are written to a cache file the
+// first time and loaded from it afterwards. A solver is read-only once built,
+// so one instance can serve any number of threads.
+class TwoPhaseSolver
+{
+    public:
+        static const int TWIST_COUNT = 2187;         // Corner orientations, 3^7
+        static const int FLIP_COUNT = 2048;          // Edge orientations, 2^11
+        static const int SLICE_COUNT = 495;          // Middle-layer edge positions, 12 choose 4
+        static const int SLICE_SORTED_COUNT = 11880; // The same with the order of those edges, 495 * 4!
+        static const int CORNER_PERM_COUNT = 40320;  // Corner permutations, 8!
+        static const int EDGE8_PERM_COUNT = 40320;   // U and D layer edge permutations in phase 2, 8!
+        static const int SLICE_PERM_COUNT = 24;      // Middle-layer edge permutations in phase 2, 4!
+        static const int FLIP_SLICE_COUNT = FLIP_COUNT * SLICE_COUNT;
+        static const int FLIP_SLICE_CLASS_COUNT = 64430; // Flip and slice positions up to the 16 U-D symmetries
+        static const int PHASE1_ENTRY_COUNT = FLIP_SLICE_CLASS_COUNT * TWIST_COUNT;
+        static const int PHASE2_MOVE_COUNT = 10;
+        // Phase 2 takes up to 18 moves, but past this searches get slow, and the phase 1 solution
+        // that needs them is rarely the way to a short total: another one is tried instead
+        static const int MAX_PHASE2_DEPTH = 11;
+    private:
+        // [coordinate * CubeState::MOVE_COUNT + move]
+        std::vector<unsigned short> m_TwistMoves;
+        std::vector<unsigned short> m_FlipMoves;
+        std::vector<unsigned short> m_SliceSortedMoves;
+        std::vector<unsigned short> m_CornerPermMoves;
+        // [coordinate * PHASE2_MOVE_COUNT + phase 2 move]
+        std::vector<unsigned short> m_Edge8PermMoves;
+
+        // Flip-slice symmetry classes, [flip * SLICE_COUNT + slice] being a flip-slice
+        std::vector<uint32_t> m_FlipSliceClass;          // [flip-slice] class << 4 | symmetry to the representative
+        std::vector<uint32_t> m_FlipSliceRepresentative; // [class] flip-slice
+        std::vector<uint16_t> m_FlipSliceStabilizer;     // [class] bit set for every symmetry that maps it onto itself
+
+        // Moves left to the phase goal: exact in phase 1, at least in phase 2
+        std::vector<unsigned char> m_Phase1Prune;          // [GetPhase1Entry], 4 bits per entry, low half first
+        std::vector<unsigned char> m_TwistSlicePrune;      // [twist * SLICE_COUNT + slice positions]
+        std::vector<unsigned char> m_FlipSlicePrune;       // [flip * SLICE_COUNT + slice positions]
+        std::vector<unsigned char> m_CornerSlicePrune;     // [corner permutation * SLICE_PERM_COUNT + slice permutation]
+        std::vector<unsigned char> m_Edge8SlicePrune;      // [edge permutation * SLICE_PERM_COUNT + slice permutation]
+
+        const CornerSymmetry& m_CornerSymmetry; // Turns twists around along with the flip-slice
+
+        struct Search;
+
+        // The state seen through the symmetry taking its flip-slice to its class representative:
+        // class * TWIST_COUNT + the twist seen that way. slice is the positions alone (GetSliceSorted / SLICE_PERM_COUNT)
+        int GetPhase1Entry(int twist, int flip, int slice) const;
+        int GetPhase1Distance(int twist, int flip, int slice) const;
+
+        void BuildFlipSliceClasses();
+        void BuildPhase1Prune();
+        void BuildTables();
+        bool LoadTables(const std::string& path);
+        bool SaveTables(const std::string& path) const;
+    public:
+        // Loads the tables from cachePath, or builds them and writes them there (an empty path skips the cache)
+        explicit TwoPhaseSolver(const std::string& cachePath = "twophase.tables");
+
+        // Moves (CubeState numbering) that solve state, at most maxLength of them (20 always exist).
+        // False for an invalid state, or when no solution that short turned up within timeoutMs
+        bool Solve(const CubeState& state, std::vector<int>& moves, int maxLength = 20, double timeoutMs = 1000.0) const;
+
+        // Coordinates, 0 on the solved cube
+        static int GetTwist(const CubeState& state);
+        static int GetFlip(const CubeState& state);
+        static int GetSliceSorted(const CubeState& state);
+        static int GetCornerPerm(const CubeState& state);
+        // Only meaningful in phase 2, where the U and D layer edges stay in those layers
+        static int GetEdge8Perm(const CubeState& state);
+};
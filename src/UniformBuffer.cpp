@@ -0,0 +1,63 @@
+#include <UniformBuffer.h>
+#include <GLState.h>
+
+#include <cstring>
+
+UniformBuffer::UniformBuffer(unsigned int binding, unsigned int size, unsigned int slotCount)
+    : m_RendererID(0), m_Binding(binding), m_Size(size), m_SlotStride(size), m_Slot(0), m_Fences(slotCount, nullptr)
+{
+    // Every slot has to start on an offset glBindBufferRange accepts
+    int alignment;
+    GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    m_SlotStride = (size + alignment - 1) / alignment * alignment;
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, m_SlotStride * slotCount, nullptr, GL_DYNAMIC_DRAW));
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+        {
+            GLCall(glDeleteSync(fence));
+        }
+    }
+    GLState::ForgetBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::SetData(const void* data)
+{
+    m_Slot = (m_Slot + 1) % m_Fences.size();
+
+    // With enough slots the GPU is long done with this one and the wait returns at once
+    if (GLsync fence = m_Fences[m_Slot])
+    {
+        GLenum result;
+        do
+        {
+            GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+        } while (result == GL_TIMEOUT_EXPIRED);
+        GLCall(glDeleteSync(fence));
+        m_Fences[m_Slot] = nullptr;
+    }
+
+    // The fence already guarantees the slot is free, so skip the driver's own synchronization
+    const unsigned int offset = m_Slot * m_SlotStride;
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(void* dst = glMapBufferRange(GL_UNIFORM_BUFFER, offset, m_Size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    std::memcpy(dst, data, m_Size);
+    GLState::CountUpload(m_Size);
+    GLCall(glUnmapBuffer(GL_UNIFORM_BUFFER));
+    GLState::BindBufferRange(GL_UNIFORM_BUFFER, m_Binding, m_RendererID, offset, m_Size);
+}
+
+void UniformBuffer::EndFrame()
+{
+    GLCall(m_Fences[m_Slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
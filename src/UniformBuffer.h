@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Binding point every Shader attaches its "FrameConstants" block to
+const unsigned int FRAME_CONSTANTS_BINDING = 0;
+
+// CPU mirror of the std140 "FrameConstants" uniform block
+struct FrameConstants
+{
+    glm::mat4 View;
+    glm::mat4 Projection;
+    glm::mat4 ViewProj;
+    float Time;
+    float Padding[3];
+};
+
+// UBO ring: one slot per frame in flight, each slot guarded by a fence so the
+// CPU only ever writes memory the GPU has finished reading
+class UniformBuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_Binding;
+        unsigned int m_Size;
+        unsigned int m_SlotStride;
+        unsigned int m_Slot;
+        std::vector<GLsync> m_Fences;
+    public:
+        UniformBuffer(unsigned int binding, unsigned int size, unsigned int slotCount = 3);
+        ~UniformBuffer();
+
+        // Write a whole block into the next slot and bind that slot to the binding point
+        void SetData(const void* data);
+
+        // Fence the current slot, call once the frame's draws have been submitted
+        void EndFrame();
+};
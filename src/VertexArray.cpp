@@ -1,13 +1,16 @@
 #include <VertexArray.h>
 #include <VertexBufferLayout.h>
+#include <GLState.h>
 
 VertexArray::VertexArray()
+    : m_AttribCount(0)
 {
     GLCall(glGenVertexArrays(1, &m_RendererID));
 }
 
 VertexArray::~VertexArray()
 {
+    GLState::ForgetVertexArray(m_RendererID);
     GLCall(glDeleteVertexArrays(1, &m_RendererID));
 }
         
@@ -16,22 +19,50 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
     Bind();
     vb.Bind();
     const auto& elements = layout.GetElements();
-    unsigned int offset = 0;
     for (unsigned int i = 0; i < elements.size(); i ++)
     {
         const auto& element = elements[i];
-        GLCall(glEnableVertexAttribArray(i));
-        GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), reinterpret_cast<const void*>(static_cast<uintptr_t>(offset))));
+        const unsigned int index = m_AttribCount + i;
+        GLCall(glEnableVertexAttribArray(index));
+        if (element.divisor != 0)
+        {
+            GLCall(glVertexAttribDivisor(index, element.divisor));
+        }
+    }
+    SetAttribPointers(layout, m_AttribCount, vb.GetOffset());
+    if (vb.GetUsage() == BufferUsage::Persistent)
+        m_RingBindings.push_back({ &vb, layout, m_AttribCount, vb.GetOffset() });
+    m_AttribCount += elements.size();
+}
+
+void VertexArray::SetAttribPointers(const VertexBufferLayout& layout, unsigned int firstAttrib, unsigned int baseOffset) const
+{
+    const auto& elements = layout.GetElements();
+    unsigned int offset = baseOffset;
+    for (unsigned int i = 0; i < elements.size(); i ++)
+    {
+        const auto& element = elements[i];
+        GLCall(glVertexAttribPointer(firstAttrib + i, element.count, element.type, element.normalized, layout.GetStride(), reinterpret_cast<const void*>(static_cast<uintptr_t>(offset))));
         offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
     }
 }
 
 void VertexArray::Bind() const
 {
-    GLCall(glBindVertexArray(m_RendererID));
+    GLState::BindVertexArray(m_RendererID);
+
+    // GL 3.3 has no base instance, so the attributes themselves have to move with the ring
+    for (RingBinding& binding : m_RingBindings)
+    {
+        if (binding.offset == binding.buffer->GetOffset())
+            continue;
+        binding.buffer->Bind();
+        SetAttribPointers(binding.layout, binding.firstAttrib, binding.buffer->GetOffset());
+        binding.offset = binding.buffer->GetOffset();
+    }
 }
 
 void VertexArray::Unbind() const
 {
-    GLCall(glBindVertexArray(0));
+    GLState::BindVertexArray(0);
 }
\ No newline at end of file
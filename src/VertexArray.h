@@ -4,17 +4,35 @@
 #include <VertexBuffer.h>
 #include <VertexBufferLayout.h>
 
+#include <vector>
+
 // VAO
 class VertexArray
 {
     private:
+        // A persistent buffer whose attributes follow its current ring segment
+        struct RingBinding
+        {
+            const VertexBuffer* buffer;
+            VertexBufferLayout layout;
+            unsigned int firstAttrib;
+            unsigned int offset;
+        };
+
         unsigned int m_RendererID;
+        unsigned int m_AttribCount;
+        mutable std::vector<RingBinding> m_RingBindings;
+
+        void SetAttribPointers(const VertexBufferLayout& layout, unsigned int firstAttrib, unsigned int baseOffset) const;
     public:
         VertexArray();
         ~VertexArray();
         
+        // Each call appends its attributes after the ones already added,
+        // so a per-instance buffer can follow the per-vertex one
         void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
 
+        // Also moves the attributes of persistent buffers onto the segment they are writing this frame
         void Bind() const;
         void Unbind() const;
-};
\ No newline at end of file
+};
@@ -1,16 +1,14 @@
 #pragma once
 
 #include <Debugger.h>
+#include <GLBuffer.h>
 
 // VBO
-class VertexBuffer
+class VertexBuffer : public GLBuffer
 {
-    private:
-        unsigned int m_RendererID;
     public:
-        VertexBuffer(const void* data, unsigned int size);
-        ~VertexBuffer();
+        VertexBuffer(const void* data, unsigned int size, BufferUsage usage = BufferUsage::Static);
 
         void Bind() const;
         void Unbind() const;
-};
\ No newline at end of file
+};
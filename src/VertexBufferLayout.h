@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 #include <Debugger.h>
 
@@ -11,6 +12,7 @@ struct VertexBufferElement
     unsigned int type;
     unsigned int count;
     unsigned char normalized;
+    unsigned int divisor; // 0 = per vertex, N = advance once every N instances
 
     static constexpr unsigned int GetSizeOfType(unsigned int type)
     {
@@ -37,8 +39,9 @@ class VertexBufferLayout
         VertexBufferLayout()
             : m_Stride(0) {}
 
+        // Divisor is 0 for per-vertex attributes, or N to advance once every N instances
         template<typename T>
-        void Push(unsigned int count)
+        void Push(unsigned int count, unsigned int divisor = 0)
         {
             // static_assert(false);
             static_assert(sizeof(T) == 0, "Unsupported type!");
@@ -49,22 +52,30 @@ class VertexBufferLayout
 };
 
 template<>
-inline void VertexBufferLayout::Push<float>(unsigned int count)
+inline void VertexBufferLayout::Push<float>(unsigned int count, unsigned int divisor)
 {
-    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
+    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE, divisor });
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
 }
 
 template<>
-inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count, unsigned int divisor)
 {
-    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
+    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE, divisor });
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
 }
 
 template<>
-inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count, unsigned int divisor)
 {
-    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
+    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE, divisor });
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+// A mat4 attribute takes 4 consecutive locations, one vec4 column each
+template<>
+inline void VertexBufferLayout::Push<glm::mat4>(unsigned int count, unsigned int divisor)
+{
+    for (unsigned int i = 0; i < count * 4; i++)
+        Push<float>(4, divisor);
 }
\ No newline at end of file
@@ -4,15 +4,27 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <Debugger.h>
-#include <VertexBuffer.h>
-#include <VertexBufferLayout.h>
-#include <IndexBuffer.h>
-#include <VertexArray.h>
-#include <Shader.h>
-#include <Texture.h>
+#include <UniformBuffer.h>
+#include <GLState.h>
 #include <Camera.h>
+#include <CubeRenderer.h>
+#include <FrameBuffer.h>
+#include <HeadlessContext.h>
+#include <FrameCapture.h>
+#include <FramePacer.h>
+#include <InputLatency.h>
+#include <Profiler.h>
+#include <RenderThread.h>
+#include <Simulation.h>
 
 #include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <algorithm>
+#include <chrono>
 
 //added
 #include "CubeFaceRotations.h"
@@ -23,259 +35,376 @@ const unsigned int height = 800;
 const float near = 0.1f;
 const float far = 100.0f;
 
-/* Cube vertices: 24 vertices (4 per face) to allow distinct colors/textures per face */
-float vertices[] = {
-    // positions          // colors           // texCoords
-    // Front face (Red)
-    -0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   0.0f, 0.0f,
-     0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   1.0f, 0.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   1.0f, 1.0f,
-    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,   0.0f, 1.0f,
-    // Back face (Orange)
-    -0.5f, -0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   0.0f, 0.0f,
-     0.5f, -0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   1.0f, 0.0f,
-     0.5f,  0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   1.0f, 1.0f,
-    -0.5f,  0.5f, -0.5f,  1.0f, 0.5f, 0.0f,   0.0f, 1.0f,
-    // Top face (White)
-    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 1.0f,   0.0f, 0.0f,
-     0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 1.0f,   1.0f, 0.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 1.0f,   1.0f, 1.0f,
-    -0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 1.0f,   0.0f, 1.0f,
-    // Bottom face (Yellow)
-    -0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,   0.0f, 0.0f,
-     0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,   1.0f, 0.0f,
-     0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,   1.0f, 1.0f,
-    -0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,   0.0f, 1.0f,
-    // Right face (Blue)
-     0.5f, -0.5f, -0.5f,  0.0f, 0.0f, 1.0f,   0.0f, 0.0f,
-     0.5f,  0.5f, -0.5f,  0.0f, 0.0f, 1.0f,   1.0f, 0.0f,
-     0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,   1.0f, 1.0f,
-     0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,   0.0f, 1.0f,
-    // Left face (Green)
-    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 0.0f,   0.0f, 0.0f,
-    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,   1.0f, 0.0f,
-    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f, 0.0f,   1.0f, 1.0f,
-    -0.5f, -0.5f,  0.5f,  0.0f, 1.0f, 0.0f,   0.0f, 1.0f
-};
-
-/* Indices for vertices order */
-unsigned int indices[] = {
-    0, 1, 2, 2, 3, 0,       // Front
-    4, 5, 6, 6, 7, 4,       // Back
-    8, 9, 10, 10, 11, 8,    // Top
-    12, 13, 14, 14, 15, 12, // Bottom
-    16, 17, 18, 18, 19, 16, // Right
-    20, 21, 22, 22, 23, 20  // Left
-};
-
-// Store the 27 cubies and their current transformation matrices
-std::vector<glm::mat4> g_cubieMatrices;
-
-// Global animation state
-RotationAnimation g_rotationAnimation;
-
-void RotateFace(glm::vec3 axis, int axisIndex, float posValue, float angle) {
-    glm::mat4 rot = glm::rotate(glm::mat4(1.0f), angle, axis);
-    for (auto& matrix : g_cubieMatrices) {
-        // Check if the cubie is on the face by looking at its current translation
-        // The translation is stored in the 4th column (index 3) of the matrix
-             if (glm::abs(matrix[3][axisIndex] - posValue) < 0.1f) {
-            // Orbit the cubie around the center of the cube
-            matrix = rot * matrix;
+int main(int argc, char* argv[])
+{
+    GLFWwindow* window = nullptr;
+    std::unique_ptr<HeadlessContext> headlessContext;
+
+    /* Parse command line options */
+    bool instanced = true;          // Draw all cubies with a single instanced call
+    bool headless = false;          // Render offscreen without a window
+    int headlessFrames = 1;
+    std::string outputDir;          // Write every frame as a PNG here (headless defaults to ".")
+    std::string tracePath;          // Write a Chrome trace of the run here
+    int cubeSize = 3;               // Cubies along each edge of the cube
+    std::string recordPath;         // Log every turn here
+    std::string replayPath;         // Play this log's turns back
+    float replaySpeed = 1.0f;       // Times the recorded pace, 0 for all at once without animation
+    double simulationRate = 120.0;  // Simulation steps per second, whatever the frame rate
+    bool threadedRendering = true;  // Replay the recorded frames on a thread that owns the context
+    PresentMode presentMode = PresentMode::VSync;
+    double frameRateLimit = 60.0;   // Frames per second with --present limit
+    std::string latencyPath;        // Follow every key event to the screen, written here as CSV
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--no-instancing") == 0)
+            instanced = false;
+        else if (std::strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            headlessFrames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            outputDir = argv[++i];
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            cubeSize = std::max(2, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc)
+            replaySpeed = std::max(0.0f, (float)std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--sim-rate") == 0 && i + 1 < argc)
+            simulationRate = std::max(1.0, std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--no-render-thread") == 0)
+            threadedRendering = false;
+        else if (std::strcmp(argv[i], "--present") == 0 && i + 1 < argc)
+        {
+            if (!ParsePresentMode(argv[++i], presentMode))
+            {
+                std::cout << "Unknown present mode " << argv[i] << ", use vsync, adaptive, uncapped or limit" << std::endl;
+                return -1;
+            }
         }
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            frameRateLimit = std::max(1.0, std::atof(argv[++i]));
+            presentMode = PresentMode::Limited;
+        }
+        else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+            latencyPath = argv[++i];
     }
-}
 
-void UpdateAnimation(float deltaTime) {
-    if (!g_rotationAnimation.active) return;
+    /* A replayed log brings its own cube size */
+    std::unique_ptr<MoveLogReader> replay;
+    if (!replayPath.empty())
+    {
+        replay = std::make_unique<MoveLogReader>(replayPath);
+        if (!replay->IsValid())
+        {
+            std::cout << "Could not read move log " << replayPath << std::endl;
+            return -1;
+        }
+        cubeSize = replay->GetCubeSize();
+    }
 
-    float step = g_rotationAnimation.speed * deltaTime;
-    float dir = (g_rotationAnimation.targetAngle > 0) ? 1.0f : -1.0f;
-    g_rotationAnimation.currentAngle += dir * step;
+    if (headless)
+    {
+        /* Create a context with no window, frames go to an FBO */
+        headlessContext = std::make_unique<HeadlessContext>();
+        if (!headlessContext->IsValid())
+        {
+            return -1;
+        }
 
-    if (glm::abs(g_rotationAnimation.currentAngle) >= glm::abs(g_rotationAnimation.targetAngle)) {
-        // Animation finished: commit the final rotation to the matrices
-        RotateFace(g_rotationAnimation.axis, g_rotationAnimation.axisIndex, g_rotationAnimation.posValue, g_rotationAnimation.targetAngle);
-        g_rotationAnimation.active = false;
-        
-    }
-}
+        /* Load GLAD so it configures OpenGL */
+        gladLoadGLLoader((GLADloadproc)HeadlessContext::GetProcAddress);
 
-int main(int argc, char* argv[])
-{
-    GLFWwindow* window;
+        /* Set up OpenGL error reporting for the selected GL_DEBUG_MODE */
+        GLDebugInit((GLADloadproc)HeadlessContext::GetProcAddress);
 
-    /* Initialize the library */
-    if (!glfwInit())
-    {
-        return -1;
+        if (outputDir.empty())
+            outputDir = ".";
     }
-    
-    /* Set OpenGL to Version 3.3.0 */
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    /* Create a windowed mode window and its OpenGL context */
-    window = glfwCreateWindow(width, height, "OpenGL", NULL, NULL);
-    if (!window)
+    else
     {
-        glfwTerminate();
-        return -1;
-    }
+        /* Initialize the library */
+        if (!glfwInit())
+        {
+            return -1;
+        }
+
+        /* Set OpenGL to Version 3.3.0 */
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#if GL_DEBUG_MODE == GL_DEBUG_CALLBACK || GL_DEBUG_MODE == GL_DEBUG_CALLBACK_SYNC
+        /* Debug output is only guaranteed in a debug context */
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
+        /* Create a windowed mode window and its OpenGL context */
+        window = glfwCreateWindow(width, height, "OpenGL", NULL, NULL);
+        if (!window)
+        {
+            glfwTerminate();
+            return -1;
+        }
 
-    /* Make the window's context current */
-    glfwMakeContextCurrent(window);
+        /* Make the window's context current */
+        glfwMakeContextCurrent(window);
 
-    /* Load GLAD so it configures OpenGL */
-    gladLoadGL();
+        /* Load GLAD so it configures OpenGL */
+        gladLoadGL();
+
+        /* Set up OpenGL error reporting for the selected GL_DEBUG_MODE */
+        GLDebugInit((GLADloadproc)glfwGetProcAddress);
+
+        /* Control frame rate: wait for the vertical blank, except when frames are uncapped or paced by FramePacer.
+           Adaptive sync needs the swap_control_tear extension, otherwise it falls back to plain vsync */
+        if (presentMode == PresentMode::Adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear")
+            && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        {
+            std::cout << "Adaptive vsync is not supported, using vsync" << std::endl;
+            presentMode = PresentMode::VSync;
+        }
+        glfwSwapInterval(presentMode == PresentMode::VSync ? 1 : presentMode == PresentMode::Adaptive ? -1 : 0);
+    }
 
-    /* Control frame rate */
-    glfwSwapInterval(1);
+    if (!outputDir.empty())
+        std::filesystem::create_directories(outputDir);
 
     /* Print OpenGL version after completing initialization */
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
 
+    /* Record CPU scopes and GPU timings for a trace */
+    if (!tracePath.empty())
+        Profiler::Init();
+
+    /* Time every key event until its effect is on screen */
+    if (!latencyPath.empty())
+        InputLatency::Init();
+
     /* Set scope so that on widow close the destructors will be called automatically */
     {
-        /* Blend to fix images with transperancy */
-        GLCall(glEnable(GL_BLEND));
-        GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-
-        /* Generate VAO, VBO, EBO and bind them */
-        VertexArray va;
-        VertexBuffer vb(vertices, sizeof(vertices));
-        IndexBuffer ib(indices, sizeof(indices));
-
-        VertexBufferLayout layout;
-        layout.Push<float>(3);  // positions
-        layout.Push<float>(3);  // colors
-        layout.Push<float>(2);  // texCoords
-        va.AddBuffer(vb, layout);
-
-        /* World Axes vertices (X=Magenta, Y=Cyan, Z=White) */
-        float axisVertices[] = {
-            // positions          // colors           // texCoords
-             0.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f,   0.5f, 0.5f, // X-axis (Magenta)
-            10.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f,   0.5f, 0.5f,
-             0.0f,  0.0f,  0.0f,  0.0f, 1.0f, 1.0f,   0.5f, 0.5f, // Y-axis (Cyan)
-             0.0f, 10.0f,  0.0f,  0.0f, 1.0f, 1.0f,   0.5f, 0.5f,
-             0.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f,   0.5f, 0.5f, // Z-axis (White)
-             0.0f,  0.0f, 10.0f,  1.0f, 1.0f, 1.0f,   0.5f, 0.5f
-        };
-        VertexArray vaAxis;
-        VertexBuffer vbAxis(axisVertices, sizeof(axisVertices));
-        // Reuse the same layout as the cube
-        vaAxis.AddBuffer(vbAxis, layout);
-
-        /* Create texture */
-        Texture texture("res/textures/plane.png");
-        texture.Bind();
-         
-        /* Create shaders */
-        Shader shader("res/shaders/basic.shader");
-        shader.Bind();
-
-        /* Unbind all to prevent accidentally modifying them */
-        va.Unbind();
-        vb.Unbind();
-        ib.Unbind();
-        shader.Unbind();
-
-        /* Enables the Depth Buffer */
-    	GLCall(glEnable(GL_DEPTH_TEST));
-
-        /* Create camera */
+        // Start from a solved cube, only its surface cubies are stored and drawn
+        InitCubies(cubeSize);
+
+        /* Turns are recorded as they start, replays go through the move queue unless they are instant */
+        std::unique_ptr<MoveLogWriter> recording;
+        if (!recordPath.empty())
+        {
+            recording = std::make_unique<MoveLogWriter>(recordPath, cubeSize);
+            if (recording->IsValid())
+                RecordTurns(recording.get());
+        }
+        if (replay)
+            ReplayTurns(replay.get(), replaySpeed);
+
+        /* Axes, cubie mesh, shaders and texture */
+        CubeRenderer renderer(g_cubieMatrices.size(), instanced);
+
+        /* Create camera, backing off as the cube grows */
+        const float cubeScale = cubeSize / 3.0f;
         Camera camera(width, height);
-        camera.SetPerspective(45.0f, near, far);
-        camera.SetPosition(glm::vec3(0.0f, 0.0f, 10.0f));
-        camera.EnableInputs(window);
-
-        // Initialize the 27 cubies at their starting positions in a 3x3x3 grid
-        g_cubieMatrices.clear();
-        for (int x = -1; x <= 1; x++)
-            for (int y = -1; y <= 1; y++)
-                for (int z = -1; z <= 1; z++)
-                    g_cubieMatrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((float)x, (float)y, (float)z)));
-        
-        /*creates variables  */
-        float lastFrameTime = 0.0f;
-        /* Loop until the user closes the window */
-        while (!glfwWindowShouldClose(window))
+        camera.SetPerspective(45.0f, near, glm::max(far, far * cubeScale));
+        camera.SetPosition(glm::vec3(0.0f, 0.0f, 10.0f * cubeScale));
+        camera.SetZoomRange(2.0f * cubeScale, 50.0f * cubeScale);
+        if (!headless)
+            camera.EnableInputs(window);
+
+        /* Headless frames are drawn into an offscreen framebuffer */
+        std::unique_ptr<FrameBuffer> offscreen;
+        if (headless)
         {
-            /* Set white background color */
-            GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+            offscreen = std::make_unique<FrameBuffer>(width, height);
+            offscreen->Bind();
+        }
 
-            float currentTime = (float)glfwGetTime();
-            float deltaTime = currentTime - lastFrameTime;
-            lastFrameTime = currentTime;
+        /* Frames are read back asynchronously and encoded on worker threads */
+        std::unique_ptr<FrameCapture> capture;
+        if (!outputDir.empty())
+        {
+            int captureWidth = width, captureHeight = height;
+            if (!headless)
+                glfwGetFramebufferSize(window, &captureWidth, &captureHeight);
+            capture = std::make_unique<FrameCapture>(captureWidth, captureHeight);
+        }
 
-            /* Update Animation */
-            UpdateAnimation(deltaTime);
+        /* Per-frame constants shared by every shader, filled once per frame by the camera */
+        UniformBuffer frameConstants(FRAME_CONSTANTS_BINDING, sizeof(FrameConstants));
 
-            /* Render here */
-            GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        /* Turns and animation step at a fixed rate on their own thread, frames draw the newest snapshot.
+           Headless runs step the simulation themselves, so their frames are reproducible */
+        Simulation simulation(1.0 / simulationRate);
+        if (!headless)
+            simulation.Start();
 
-            /* Initialize uniform color */
-            glm::vec4 color = glm::vec4(1.0);
+        /*creates variables  */
+        unsigned long long frameCount = 0, bindsIssued = 0, bindsSkipped = 0;
 
-            glm::mat4 view = camera.GetViewMatrix();
-            glm::mat4 proj = camera.GetProjectionMatrix();
+        /* Replays one recorded frame: the only place GL is called from while the loop runs */
+        auto replayFrame = [&](const RenderCommandBuffer& frame)
+        {
+            PROFILE_SCOPE("ReplayFrame");
+            {
+                PROFILE_SCOPE("Draw");
+                GPU_PROFILE_SCOPE("Draw");
+                for (const RenderCommand& command : frame.GetCommands())
+                {
+                    switch (command.type)
+                    {
+                        case RenderCommandType::Clear:
+                            GLCall(glClearColor(command.color.r, command.color.g, command.color.b, command.color.a));
+                            GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+                            break;
+                        case RenderCommandType::SetFrameConstants:
+                            frameConstants.SetData(&frame.GetFrameConstants(command));
+                            break;
+                        case RenderCommandType::Capture:
+                        {
+                            /* Queue the frame for writing, then collect frames whose readback has finished */
+                            PROFILE_SCOPE("Capture");
+                            capture->Capture(headless ? offscreen->GetRendererID() : 0, frame.GetString(command));
+                            capture->Poll();
+                            break;
+                        }
+                        default:
+                            renderer.Execute(frame, command);
+                            break;
+                    }
+                }
+            }
 
-            /* Bind shader and common uniforms once per frame */
-            shader.Bind();
-            shader.SetUniform4f("u_Color", color);
-            shader.SetUniform1i("u_Texture", 0);
+            /* Fence this frame's slot of the constants ring */
+            frameConstants.EndFrame();
 
-            /* Disable depth test so axes are drawn on top of everything */
-            GLCall(glDisable(GL_DEPTH_TEST));
+            /* Collect how many binds went to the driver and how many were dropped */
+            GLState::EndFrame();
+            bindsIssued += GLState::GetFrameCounters().issued;
+            bindsSkipped += GLState::GetFrameCounters().skipped;
 
-            /* Draw World Axes (Fixed in space) */
-            shader.SetUniformMat4f("u_MVP", proj * view);
-            vaAxis.Bind();
-            GLCall(glLineWidth(2.0f));
-            GLCall(glDrawArrays(GL_LINES, 0, 6));
+            /* Collect the GPU timings that have arrived, without waiting for the rest */
+            Profiler::EndFrame();
+            InputLatency::FrameSubmitted(frame.GetTurnsSettled());
 
-            /* Draw Local Axes (Rotating with the cube) */
-            shader.SetUniformMat4f("u_MVP", proj * view);
-            GLCall(glLineWidth(5.0f));
-            GLCall(glDrawArrays(GL_LINES, 0, 6));
-            GLCall(glLineWidth(1.0f)); // Reset line width
+            if (headless)
+                return;
 
-            /* Re-enable depth test for the cube */
-            GLCall(glEnable(GL_DEPTH_TEST));
+            /* Swap front and back buffers */
+            {
+                PROFILE_SCOPE("SwapBuffers");
+                glfwSwapBuffers(window);
+            }
+            InputLatency::FramePresented(frame.GetTurnsSettled());
+        };
 
-            /* Draw the 27 cubies using their stored matrices */
-            va.Bind();
-            ib.Bind();
-            for (size_t i = 0; i < g_cubieMatrices.size(); i++)
+        /* The main thread records frame N + 1 while the render thread submits and swaps frame N */
+        RenderThread renderThread([&](bool current)
+        {
+            if (headless)
+                headlessContext->MakeCurrent(current);
+            else
+                glfwMakeContextCurrent(current ? window : nullptr);
+        }, replayFrame, threadedRendering);
+
+        /* With --present limit frames start at a fixed rate, as late as they can so input is fresh */
+        std::unique_ptr<FramePacer> pacer;
+        if (presentMode == PresentMode::Limited)
+            pacer = std::make_unique<FramePacer>(frameRateLimit);
+        const auto loopStart = std::chrono::steady_clock::now();
+
+        /* Loop until the user closes the window, or the requested frames are written */
+        while (headless ? frameCount < (unsigned long long)headlessFrames : !glfwWindowShouldClose(window))
+        {
+            PROFILE_SCOPE("Frame");
+            if (pacer)
+                pacer->Wait();
+
+            /* Headless runs advance a fixed 1/60 s per frame so their output is reproducible */
+            float currentTime = headless ? frameCount / 60.0f : (float)glfwGetTime();
+            double simulationTime = simulation.Now();
+            if (headless)
             {
-                glm::mat4 model = g_cubieMatrices[i];
-
-                // If this cubie is currently animating, apply the partial rotation
-                if (g_rotationAnimation.active) {
-                    for (size_t idx : g_rotationAnimation.movingCubieIndices) {
-                        if (idx == i) {
-                            glm::mat4 animRot = glm::rotate(glm::mat4(1.0f), g_rotationAnimation.currentAngle, g_rotationAnimation.axis);
-                            model = animRot * model;
-                            break;
-                        }
-                    }
-                }
+                PROFILE_SCOPE("Simulation");
+                simulationTime = frameCount / 60.0;
+                simulation.AdvanceTo(simulationTime);
+            }
+
+            /* Take the newest state without waiting for the simulation, and place the frame within its step */
+            const CubeSnapshot& snapshot = simulation.Acquire();
+            const float alpha = simulation.GetAlpha(snapshot, simulationTime);
 
-                glm::mat4 mvp = proj * view * model;
-                shader.SetUniformMat4f("u_MVP", mvp);
-                GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+            /* Record the frame: plain data, no GL calls */
+            RenderCommandBuffer& frame = renderThread.BeginFrame();
+            {
+                PROFILE_SCOPE("Record");
+
+                /* Set white background color */
+                frame.Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+                frame.SetTurnsSettled(snapshot.turnsSettled);
+                frame.SetFrameConstants(camera.GetFrameConstants(currentTime));
+                renderer.Record(frame, snapshot, alpha);
+
+                if (capture)
+                {
+                    char filename[32];
+                    std::snprintf(filename, sizeof(filename), "/frame_%04llu.png", frameCount);
+                    frame.Capture(outputDir + filename);
+                }
             }
+            renderThread.Submit();
+            frameCount++;
 
-            /* Swap front and back buffers */
-            glfwSwapBuffers(window);
+            if (headless)
+                continue;
 
             /* Poll for and process events */
-            glfwPollEvents();
+            {
+                PROFILE_SCOPE("PollEvents");
+                glfwPollEvents();
+            }
+        }
+
+        /* Let the last frames replay and take the context back */
+        renderThread.Stop();
+        const double loopSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
+
+        /* Stop stepping, then recording before the log goes */
+        simulation.Stop();
+        RecordTurns(nullptr);
+        if (simulation.GetDroppedSeconds() > 0.0)
+            std::cout << "Simulation fell behind, " << simulation.GetDroppedSeconds() << " s skipped" << std::endl;
+
+        if (frameCount > 0)
+        {
+            std::cout << "GL binds per frame: " << (double)bindsIssued / frameCount << " issued, "
+                << (double)bindsSkipped / frameCount << " skipped (" << frameCount << " frames)" << std::endl;
+            /* Headless frames are never presented, so there is no present mode to report */
+            std::cout << frameCount << " frames in " << loopSeconds << " s, " << frameCount / loopSeconds << " fps";
+            if (!headless)
+                std::cout << " (present mode " << GetPresentModeName(presentMode) << ")";
+            std::cout << std::endl;
+            if (pacer)
+                std::cout << "Frame pacing: " << pacer->GetAverageLateness() * 1e6 << " us late on average" << std::endl;
+        }
+
+        if (!InputLatency::WriteReport(latencyPath))
+            std::cout << "Failed to write " << latencyPath << std::endl;
+
+        if (Profiler::IsEnabled())
+        {
+            /* Let the last frames' GPU timings arrive before writing the trace */
+            GLCall(glFinish());
+            Profiler::EndFrame();
+            if (!Profiler::WriteChromeTrace(tracePath))
+                std::cout << "Failed to write " << tracePath << std::endl;
+            Profiler::Shutdown();
         }
     }
 
-    glfwTerminate();
+    if (!headless)
+        glfwTerminate();
     return 0;
 }
\ No newline at end of file
@@ -8,11 +8,19 @@ layout(location = 2) in vec2 texCoord;
 out vec4 v_Color;
 out vec2 v_TexCoord;
 
-uniform mat4 u_MVP;
+layout(std140) uniform FrameConstants
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProj;
+	float u_Time;
+};
+
+uniform mat4 u_Model;
 
 void main()
 {
-	gl_Position = u_MVP *  vec4(position.x, position.y, position.z, 1.0);
+	gl_Position = u_ViewProj * u_Model * vec4(position.x, position.y, position.z, 1.0);
 	v_Color = vec4(color.x, color.y, color.z, 1.0);
 	v_TexCoord = texCoord;
 }
@@ -0,0 +1,52 @@
+#shader vertex
+#version 330
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in mat4 model; // Per instance, takes locations 3-6
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+layout(std140) uniform FrameConstants
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProj;
+	float u_Time;
+};
+
+// Instances come in batches, the resting cubies first and then one batch per turning layer
+// (MAX_TURNING_LAYERS in CubeFaceRotations.h). u_BatchEnds holds the instance each batch ends at
+#define MAX_BATCHES 9
+uniform mat4 u_BatchPlacements[MAX_BATCHES];
+uniform int u_BatchEnds[MAX_BATCHES];
+
+void main()
+{
+	int batch = 0;
+	while (batch < MAX_BATCHES - 1 && gl_InstanceID >= u_BatchEnds[batch])
+		batch++;
+	mat4 placement = u_BatchPlacements[batch];
+	gl_Position = u_ViewProj * placement * model * vec4(position.x, position.y, position.z, 1.0);
+	v_Color = vec4(color.x, color.y, color.z, 1.0);
+	v_TexCoord = texCoord;
+}
+
+#shader fragment
+#version 330
+
+layout(location = 0) out vec4 FragColor;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+uniform vec4 u_Color;
+uniform sampler2D u_Texture;
+
+void main()
+{
+	vec4 texColor = texture(u_Texture, v_TexCoord) * u_Color;
+	FragColor = texColor * v_Color;
+}
@@ -0,0 +1,41 @@
+// Pattern database generator for OptimalSolver: runs a breadth-first search over
+// the corners and over the edges, and writes the two tables into a directory the
+// solver maps them from. Build and run it through make pdb.
+//
+//   pdb_gen [--dir DIR] [--threads N]
+
+#include <OptimalSolver.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+    std::string directory = "pdb";
+    int threads = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+            directory = argv[++i];
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!OptimalSolver::GenerateDatabases(directory, threads))
+        return 1;
+    // Read the files back the way the solver will
+    OptimalSolver solver(directory);
+    if (!solver.IsLoaded())
+    {
+        std::cerr << "The tables written to " << directory << " don't load" << std::endl;
+        return 1;
+    }
+    return 0;
+}